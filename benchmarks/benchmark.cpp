@@ -0,0 +1,345 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include "../src/DefaultRandomVectorGenerator.h"
+#include "../src/DefaultTranspositionVectorGenerator.h"
+#include "../src/QuantizedRandomVectorGenerator.h"
+#include "../src/PermutationDecoder.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/Philox.h"
+#include "../src/Solver.h"
+#include "../src/IslandSolver.h"
+#include "../src/SteadyStateSolver.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/RandomVectorEvaluator.h"
+#include "../examples/tsp/TranspositionVectorEvaluator.h"
+
+/**
+ * Benchmarks of the main steps of the algorithm: crossover, random-key decoding, evaluation of
+ * TSP tours, full generations and whole runs of the island model and of the steady-state solver. Results are written to the standard output as CSV, one line per
+ * benchmark, so that runs before and after a change can be compared.
+ * Usage: benchmark [--min-time <seconds>] [--data <TSPLIB directory>] [--filter <substring>]
+ */
+namespace {
+    using namespace bga;
+    using namespace bga::tsp;
+
+    /**
+     * Bundled instances, from the smallest to the largest.
+     */
+    const auto instances = std::vector<std::string>{"gr17", "gr21", "gr24", "gr48", "hk48", "gr120", "pa561"};
+
+    /**
+     * Chromosome lengths used by the crossover and decoding benchmarks.
+     */
+    const auto lengths = std::vector<uint32_t>{16u, 64u, 256u, 1024u, 4096u, 16384u};
+
+    struct Options {
+        double min_time_s = 0.25;
+        std::string data_dir = RKBGA_DATA_DIR;
+        std::string filter;
+    };
+
+    /**
+     * Description of a benchmark, i.e. the first columns of its line of results.
+     */
+    struct Case {
+        std::string benchmark;
+        std::string variant;
+        std::string instance;
+        uint32_t size;
+        uint32_t population;
+        uint32_t threads;
+    };
+
+    /**
+     * Keeps the results of the benchmarked operations alive, so that they are not optimised away.
+     */
+    volatile double sink = 0.0;
+
+    void print_header() {
+        std::cout << "benchmark,variant,instance,size,population,threads,repetitions,seconds,ns_per_op,ops_per_s" << std::endl;
+    }
+
+    /**
+     * Runs an operation repeatedly, in batches of doubling size, for at least the given time
+     * (after a warm-up run), and prints its average duration.
+     */
+    void run(const Options& options, const Case& what, const std::function<double()>& operation) {
+        const auto name = what.benchmark + "/" + what.variant + "/" + what.instance;
+        if(!options.filter.empty() && name.find(options.filter) == std::string::npos) { return; }
+
+        sink = sink + operation();
+
+        auto repetitions = uint64_t{0};
+        auto batch = uint64_t{1};
+        auto elapsed_s = 0.0;
+
+        while(elapsed_s < options.min_time_s) {
+            const auto start = std::chrono::steady_clock::now();
+            auto checksum = 0.0;
+            for(auto k = uint64_t{0}; k < batch; k++) { checksum += operation(); }
+            elapsed_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            sink = sink + checksum;
+            repetitions += batch;
+            batch *= 2u;
+        }
+
+        const auto ns_per_op = 1e9 * elapsed_s / static_cast<double>(repetitions);
+
+        std::cout << what.benchmark << "," << what.variant << "," << what.instance << "," << what.size << ",";
+        std::cout << what.population << "," << what.threads << "," << repetitions << "," << elapsed_s << ",";
+        std::cout << ns_per_op << "," << 1e9 / ns_per_op << std::endl;
+    }
+
+    /**
+     * A visitor which does nothing, so that no I/O is timed.
+     */
+    template<class Individual>
+    struct SilentVisitor {
+        void at_start(const IndividualWithObjValue<Individual>&) const {}
+        void at_iteration(const IndividualWithObjValue<Individual>&, uint32_t, float) const {}
+        void at_end(const IndividualWithObjValue<Individual>&, uint32_t, float) const {}
+    };
+
+    void benchmark_crossover(const Options& options) {
+        auto rng = Philox4x32{1u, 0u};
+        auto keys = std::uniform_real_distribution<float>{0.0f, 1.0f};
+
+        for(const auto length : lengths) {
+            auto first = std::vector<float>(length);
+            auto second = std::vector<float>(length);
+            for(auto i = 0u; i < length; i++) { first[i] = keys(rng); second[i] = keys(rng); }
+
+            const auto elite = RandomVectorIndividual{first};
+            const auto non_elite = RandomVectorIndividual{second};
+
+            run(options, Case{"crossover", "random_key", "-", length, 0u, 1u}, [&] () {
+                return elite.biased_crossover_with(non_elite, 0.7f, rng).component(0);
+            });
+        }
+
+        for(const auto length : lengths) {
+            auto generator = QuantizedRandomVectorGenerator<>{length, 1u};
+            const auto elite = generator.generate();
+            const auto non_elite = generator.generate();
+
+            run(options, Case{"crossover", "quantized_random_key", "-", length, 0u, 1u}, [&] () {
+                return static_cast<double>(elite.biased_crossover_with(non_elite, 0.7f, rng).component(0));
+            });
+        }
+
+        for(const auto length : lengths) {
+            const auto nodes = length / 2u + 1u;
+            auto generator = DefaultTranspositionVectorGenerator{nodes, 1u};
+            const auto elite = generator.generate();
+            const auto non_elite = generator.generate();
+
+            run(options, Case{"crossover", "transposition", "-", elite.size(), 0u, 1u}, [&] () {
+                return static_cast<double>(elite.biased_crossover_with(non_elite, 0.7f, rng).component(0));
+            });
+        }
+    }
+
+    void benchmark_decoding(const Options& options) {
+        auto rng = Philox4x32{2u, 0u};
+        auto distribution = std::uniform_real_distribution<float>{0.0f, 1.0f};
+
+        for(const auto length : lengths) {
+            auto keys = std::vector<float>(length);
+            for(auto& key : keys) { key = distribution(rng); }
+
+            auto permutation = std::vector<uint32_t>(length);
+
+            run(options, Case{"decoding", "decode_permutation", "-", length, 0u, 1u}, [&] () {
+                decode_permutation(keys.data(), length, permutation);
+                return static_cast<double>(permutation[0]);
+            });
+
+            run(options, Case{"decoding", "std_sort", "-", length, 0u, 1u}, [&] () {
+                std::iota(permutation.begin(), permutation.end(), 0u);
+                std::sort(permutation.begin(), permutation.end(), [&] (auto i, auto j) { return keys[i] < keys[j]; });
+                return static_cast<double>(permutation[0]);
+            });
+
+            const auto quantized = QuantizedRandomVectorGenerator<>{length, 2u}.generate();
+
+            run(options, Case{"decoding", "quantized", "-", length, 0u, 1u}, [&] () {
+                quantized.decode(permutation);
+                return static_cast<double>(permutation[0]);
+            });
+        }
+    }
+
+    void benchmark_evaluation(const Options& options) {
+        for(const auto& instance : instances) {
+            const auto graph = Graph{options.data_dir + "/" + instance + ".tsp"};
+
+            auto random_keys = DefaultRandomVectorGenerator{graph.num_nodes(), 3u};
+            const auto random_key_evaluator = RandomVectorEvaluator{graph};
+            const auto random_key = random_keys.generate();
+
+            run(options, Case{"evaluation", "random_key", instance, graph.num_nodes(), 0u, 1u}, [&] () {
+                return random_key_evaluator.evaluate(random_key);
+            });
+
+            auto transpositions = DefaultTranspositionVectorGenerator{graph.num_nodes(), 3u};
+            const auto transposition_evaluator = TranspositionVectorEvaluator{graph};
+            const auto transposition = transpositions.generate();
+
+            run(options, Case{"evaluation", "transposition", instance, graph.num_nodes(), 0u, 1u}, [&] () {
+                return transposition_evaluator.evaluate(transposition);
+            });
+        }
+    }
+
+    /**
+     * Transposition evaluator without delta evaluation, to measure what the latter saves.
+     */
+    class FullTranspositionVectorEvaluator {
+        const TranspositionVectorEvaluator evaluator;
+
+    public:
+        using individual_type = TranspositionVectorIndividual;
+
+        explicit FullTranspositionVectorEvaluator(const Graph& graph) : evaluator{graph} {}
+
+        float evaluate(const TranspositionVectorIndividual& individual) const { return evaluator.evaluate(individual); }
+
+        void evaluate_batch(Span<const TranspositionVectorIndividual> individuals, Span<float> objvalues) const {
+            evaluator.evaluate_batch(individuals, objvalues);
+        }
+    };
+
+    template<class Generator, class Evaluator>
+    void benchmark_generation(const Options& options, const std::string& variant, const std::string& instance, const Graph& graph) {
+        using Individual = typename Generator::individual_type;
+
+        const auto hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+        auto thread_counts = std::vector<uint32_t>{1u, 2u, 4u, hardware_threads};
+        std::sort(thread_counts.begin(), thread_counts.end());
+        thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+        for(const auto population : {100u, 250u, 1000u}) {
+            for(const auto threads : thread_counts) {
+                for(const auto pipelined : {false, true}) {
+                    auto generator = Generator{graph.num_nodes(), 4u};
+                    const auto evaluator = Evaluator{graph};
+                    const auto visitor = SilentVisitor<Individual>{};
+                    const auto params = ParamsBuilder{}.with_population_size(population).with_num_threads(threads).with_seed(4u)
+                                                       .with_pipelined_generations(pipelined).build();
+                    auto solver = Solver<Generator, Evaluator, SilentVisitor<Individual>>{params, generator, evaluator, visitor};
+
+                    solver.initialise();
+
+                    const auto name = pipelined ? variant + "_pipelined" : variant;
+                    run(options, Case{"generation", name, instance, graph.num_nodes(), population, threads}, [&] () {
+                        solver.evolve();
+                        return static_cast<double>(solver.best().objvalue);
+                    });
+                }
+            }
+        }
+    }
+
+    void benchmark_generations(const Options& options) {
+        for(const auto& instance : {std::string{"gr48"}, std::string{"pa561"}}) {
+            const auto graph = Graph{options.data_dir + "/" + instance + ".tsp"};
+            benchmark_generation<DefaultRandomVectorGenerator, RandomVectorEvaluator>(options, "random_key", instance, graph);
+            benchmark_generation<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>(options, "transposition", instance, graph);
+            benchmark_generation<DefaultTranspositionVectorGenerator, FullTranspositionVectorEvaluator>(options, "transposition_full", instance, graph);
+        }
+    }
+    /**
+     * Whole runs of the island model, with a fixed number of generations per island and one thread
+     * per island, with and without migration.
+     */
+    void benchmark_islands(const Options& options) {
+        using Visitor = SilentVisitor<RandomVectorIndividual>;
+
+        const auto graph = Graph{options.data_dir + "/gr48.tsp"};
+        const auto evaluator = RandomVectorEvaluator{graph};
+        const auto visitor = Visitor{};
+
+        for(const auto num_islands : {1u, 2u, 4u}) {
+            for(const auto migration_freq_generations : {0u, 10u}) {
+                const auto generator = DefaultRandomVectorGenerator{graph.num_nodes(), 5u};
+                const auto params = ParamsBuilder{}.with_population_size(100u).with_max_generations(50u).with_num_islands(num_islands)
+                                                   .with_num_threads(1u).with_migration_freq_generations(migration_freq_generations)
+                                                   .with_seed(5u).build();
+                const auto solver = IslandSolver<DefaultRandomVectorGenerator, RandomVectorEvaluator, Visitor>{params, generator, evaluator, visitor};
+
+                const auto variant = (migration_freq_generations > 0u) ? std::string{"random_key_migration"} : std::string{"random_key"};
+                run(options, Case{"islands", variant, "gr48", graph.num_nodes(), 100u, num_islands}, [&] () {
+                    return static_cast<double>(solver.solve().objvalue);
+                });
+            }
+        }
+    }
+    /**
+     * Whole runs of the steady-state solver, against the generational one, with the same number of
+     * new individuals.
+     */
+    void benchmark_steady_state(const Options& options) {
+        using Visitor = SilentVisitor<RandomVectorIndividual>;
+
+        const auto graph = Graph{options.data_dir + "/gr48.tsp"};
+        const auto evaluator = RandomVectorEvaluator{graph};
+        const auto visitor = Visitor{};
+
+        for(const auto threads : {1u, 2u, 4u}) {
+            const auto generator = DefaultRandomVectorGenerator{graph.num_nodes(), 6u};
+            const auto params = ParamsBuilder{}.with_population_size(100u).with_max_generations(50u).with_num_threads(threads).with_seed(6u).build();
+            const auto steady_state = SteadyStateSolver<DefaultRandomVectorGenerator, RandomVectorEvaluator, Visitor>{params, generator, evaluator, visitor};
+            const auto generational = Solver<DefaultRandomVectorGenerator, RandomVectorEvaluator, Visitor>{params, generator, evaluator, visitor};
+
+            run(options, Case{"steady_state", "random_key", "gr48", graph.num_nodes(), 100u, threads}, [&] () {
+                return static_cast<double>(steady_state.solve().objvalue);
+            });
+
+            run(options, Case{"steady_state", "random_key_generational", "gr48", graph.num_nodes(), 100u, threads}, [&] () {
+                return static_cast<double>(generational.solve().objvalue);
+            });
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    auto options = Options{};
+
+    for(auto i = 1; i < argc; i++) {
+        const auto argument = std::string(argv[i]);
+
+        if(argument == "--min-time" && i + 1 < argc) { options.min_time_s = std::strtod(argv[++i], nullptr); }
+        else if(argument == "--data" && i + 1 < argc) { options.data_dir = argv[++i]; }
+        else if(argument == "--filter" && i + 1 < argc) { options.filter = argv[++i]; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--min-time <seconds>] [--data <TSPLIB directory>] [--filter <substring>]" << std::endl;
+            return 1;
+        }
+    }
+
+    print_header();
+    benchmark_crossover(options);
+    benchmark_decoding(options);
+    benchmark_evaluation(options);
+    benchmark_generations(options);
+    benchmark_islands(options);
+    benchmark_steady_state(options);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_DISTANCEKERNELS_H
+#define RKBGA_DISTANCEKERNELS_H
+
+#include <cmath>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#ifndef RKBGA_X86_KERNELS
+#define RKBGA_X86_KERNELS
+#endif
+#include <immintrin.h>
+#endif
+
+namespace bga {
+    namespace tsp {
+        /**
+         * How the distance between two nodes is obtained, with the names and rounding rules of TSPLIB.
+         */
+        enum class EdgeWeightType : uint32_t {
+            /**
+             * Distances are given by a matrix.
+             */
+            Explicit,
+
+            /**
+             * Euclidean distance between planar coordinates, rounded to the nearest integer.
+             */
+            Euclidean2D,
+
+            /**
+             * Euclidean distance between planar coordinates, rounded up.
+             */
+            Ceil2D,
+
+            /**
+             * Great-circle distance in kilometres between (latitude, longitude) coordinates, given in DDD.MM format.
+             */
+            Geographical,
+
+            /**
+             * Pseudo-Euclidean distance of the ATT instances.
+             */
+            Att
+        };
+
+        /**
+         * Kernels computing distances from node coordinates, on demand. The cost of a tour is computed
+         * four edges at a time with AVX2 when the CPU supports it, or else by scalar code, which gives
+         * the same result. Geographical distances are always computed by scalar code.
+         */
+        namespace distance {
+            /**
+             * Converts a TSPLIB coordinate in DDD.MM format to radians.
+             */
+            inline double geographical_radians(double coordinate) {
+                constexpr auto pi = 3.141592;
+                const auto degrees = static_cast<double>(static_cast<int64_t>(coordinate));
+                const auto minutes = coordinate - degrees;
+                return pi * (degrees + 5.0 * minutes / 3.0) / 180.0;
+            }
+
+            /**
+             * Distance between two nodes, given their coordinates (in radians, for Geographical).
+             */
+            inline double between(double x1, double y1, double x2, double y2, EdgeWeightType type) {
+                const auto dx = x1 - x2;
+                const auto dy = y1 - y2;
+
+                switch(type) {
+                    case EdgeWeightType::Ceil2D:
+                        return std::ceil(std::sqrt(dx * dx + dy * dy));
+                    case EdgeWeightType::Att: {
+                        const auto r = std::sqrt((dx * dx + dy * dy) / 10.0);
+                        const auto t = std::floor(r + 0.5);
+                        return (t < r) ? t + 1.0 : t;
+                    }
+                    case EdgeWeightType::Geographical: {
+                        constexpr auto radius = 6378.388;
+                        const auto q1 = std::cos(y1 - y2);
+                        const auto q2 = std::cos(x1 - x2);
+                        const auto q3 = std::cos(x1 + x2);
+                        return std::floor(radius * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+                    }
+                    default:
+                        return std::floor(std::sqrt(dx * dx + dy * dy) + 0.5);
+                }
+            }
+
+            /**
+             * Sums the lengths of the edges (tour[i], tour[i+1]) for i in [begin, end).
+             */
+            inline double path_cost_scalar(const double* x, const double* y, const uint32_t* tour, uint32_t begin, uint32_t end, EdgeWeightType type) {
+                auto cost = 0.0;
+                for(auto i = begin; i < end; i++) {
+                    cost += between(x[tour[i]], y[tour[i]], x[tour[i + 1u]], y[tour[i + 1u]], type);
+                }
+                return cost;
+            }
+
+            /**
+             * Signature of the vectorised kernels: they sum the lengths of the edges (tour[i], tour[i+1])
+             * for i in [0, size), in blocks, and return the number of edges processed; the remaining ones
+             * are left to the scalar code.
+             */
+            using Kernel = uint32_t (*)(const double*, const double*, const uint32_t*, uint32_t, EdgeWeightType, double&);
+
+#ifdef RKBGA_X86_KERNELS
+            // GCC warns about the undefined pass-through operand of the gather intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+            __attribute__((target("avx2")))
+            inline uint32_t path_cost_avx2(const double* x, const double* y, const uint32_t* tour, uint32_t size, EdgeWeightType type, double& cost) {
+                const auto half = _mm256_set1_pd(0.5);
+                const auto one = _mm256_set1_pd(1.0);
+                const auto ten = _mm256_set1_pd(10.0);
+                auto sum = _mm256_setzero_pd();
+                auto i = 0u;
+
+                for(; i + 4u <= size; i += 4u) {
+                    const auto from = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tour + i));
+                    const auto to = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tour + i + 1u));
+
+                    const auto dx = _mm256_sub_pd(_mm256_i32gather_pd(x, from, 8), _mm256_i32gather_pd(x, to, 8));
+                    const auto dy = _mm256_sub_pd(_mm256_i32gather_pd(y, from, 8), _mm256_i32gather_pd(y, to, 8));
+                    const auto squared = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+
+                    auto length = __m256d{};
+                    if(type == EdgeWeightType::Ceil2D) {
+                        length = _mm256_ceil_pd(_mm256_sqrt_pd(squared));
+                    } else if(type == EdgeWeightType::Att) {
+                        const auto r = _mm256_sqrt_pd(_mm256_div_pd(squared, ten));
+                        const auto t = _mm256_floor_pd(_mm256_add_pd(r, half));
+                        length = _mm256_blendv_pd(t, _mm256_add_pd(t, one), _mm256_cmp_pd(t, r, _CMP_LT_OQ));
+                    } else {
+                        length = _mm256_floor_pd(_mm256_add_pd(_mm256_sqrt_pd(squared), half));
+                    }
+
+                    sum = _mm256_add_pd(sum, length);
+                }
+
+                alignas(32) double lanes[4];
+                _mm256_store_pd(lanes, sum);
+                cost = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+                return i;
+            }
+#pragma GCC diagnostic pop
+#endif
+
+            /**
+             * The kernel used on this machine, chosen once, or nullptr if the CPU supports none.
+             */
+            inline Kernel kernel() {
+                static const auto selected = [] () -> Kernel {
+#ifdef RKBGA_X86_KERNELS
+                    __builtin_cpu_init();
+                    if(__builtin_cpu_supports("avx2")) { return &path_cost_avx2; }
+#endif
+                    return nullptr;
+                }();
+                return selected;
+            }
+
+            /**
+             * Cost of a closed tour, computed from the coordinates of its nodes.
+             * Distances are integral, so the sum does not depend on the order of the additions.
+             * @param x     First coordinate of each node (in radians, for Geographical).
+             * @param y     Second coordinate of each node (in radians, for Geographical).
+             * @param tour  The order in which the nodes are visited.
+             * @param size  Number of nodes; must be positive.
+             * @param type  The distance function; must not be Explicit.
+             */
+            inline double tour_cost(const double* x, const double* y, const uint32_t* tour, uint32_t size, EdgeWeightType type) {
+                auto cost = 0.0;
+                auto i = 0u;
+
+                if(type != EdgeWeightType::Geographical) {
+                    if(const auto vectorised = kernel()) { i = vectorised(x, y, tour, size - 1u, type, cost); }
+                }
+
+                cost += path_cost_scalar(x, y, tour, i, size - 1u, type);
+                return cost + between(x[tour[size - 1u]], y[tour[size - 1u]], x[tour[0]], y[tour[0]], type);
+            }
+        }
+    }
+}
+
+#endif //RKBGA_DISTANCEKERNELS_H
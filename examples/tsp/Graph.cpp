@@ -2,64 +2,220 @@
 // Created by alberto on 27/08/16.
 //
 
+#include <array>
+#include <cmath>
+#include <limits>
 #include <iostream>
 #include <fstream>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "Graph.h"
+#include "InstanceFile.h"
 
 namespace bga {
     namespace tsp {
-        float Graph::get_distance(uint32_t i, uint32_t j) const {
-            assert(i < distance.size());
-            assert(j < distance[i].size());
-            return distance[i][j];
+        namespace {
+            /**
+             * Alignment of the distance matrix: a cache line.
+             */
+            constexpr std::size_t matrix_alignment = 64u;
+
+            std::size_t distance_size(DistanceType type) { return (type == DistanceType::UInt16) ? sizeof(uint16_t) : sizeof(float); }
+
+            std::size_t num_entries(uint32_t num_nodes, MatrixLayout layout) {
+                const auto n = static_cast<std::size_t>(num_nodes);
+                return (layout == MatrixLayout::Full) ? n * n : n * (n + 1u) / 2u;
+            }
+
+            /**
+             * Cost of a tour, for a given type and layout of the matrix. Integral distances are summed exactly.
+             */
+            template<class Distance, MatrixLayout Layout>
+            float tour_cost_of(const Distance* distance, uint32_t num_nodes, const std::vector<uint32_t>& tour) {
+                using Sum = std::conditional_t<std::is_integral<Distance>::value, uint64_t, float>;
+
+                auto at = [distance,num_nodes] (uint32_t i, uint32_t j) -> Sum {
+                    if constexpr(Layout == MatrixLayout::Full) {
+                        return distance[static_cast<std::size_t>(i) * num_nodes + j];
+                    } else {
+                        if(i < j) { std::swap(i, j); }
+                        return distance[static_cast<std::size_t>(i) * (i + 1u) / 2u + j];
+                    }
+                };
+
+                // Independent partial sums let the loads of consecutive edges overlap.
+                auto cost = std::array<Sum, 4>{};
+                auto i = 0u;
+                const auto n = static_cast<uint32_t>(tour.size());
+
+                for(; i + 4u < n; i += 4u) {
+                    cost[0] += at(tour[i], tour[i+1]);
+                    cost[1] += at(tour[i+1], tour[i+2]);
+                    cost[2] += at(tour[i+2], tour[i+3]);
+                    cost[3] += at(tour[i+3], tour[i+4]);
+                }
+                for(; i + 1u < n; i++) {
+                    cost[0] += at(tour[i], tour[i+1]);
+                }
+                cost[0] += at(tour[n - 1], tour[0]);
+
+                return static_cast<float>((cost[0] + cost[1]) + (cost[2] + cost[3]));
+            }
         }
 
-        Graph::Graph(std::string filename) {
-            auto is = std::ifstream(filename);
+        void Graph::allocate(uint32_t num_nodes, DistanceType distance_type, MatrixLayout matrix_layout) {
+            nodes = num_nodes;
+            type = distance_type;
+            layout = matrix_layout;
+            weight = EdgeWeightType::Explicit;
+
+            // std::aligned_alloc wants a multiple of the alignment.
+            const auto bytes = num_entries(num_nodes, matrix_layout) * distance_size(distance_type);
+            const auto padded = (bytes + matrix_alignment - 1u) / matrix_alignment * matrix_alignment;
+
+            auto* buffer = static_cast<unsigned char*>(std::aligned_alloc(matrix_alignment, std::max(padded, matrix_alignment)));
 
-            if(is.fail()) {
+            if(!buffer) {
+                std::cerr << "Could not allocate " << bytes << " bytes for the distance matrix" << std::endl;
+                _Exit(1);
+            }
+
+            storage = std::shared_ptr<const unsigned char>(buffer, [] (const unsigned char* p) { std::free(const_cast<unsigned char*>(p)); });
+        }
+
+        void Graph::store(uint32_t num_nodes, MatrixLayout matrix_layout, const std::vector<float>& entries, bool allow_narrow) {
+            const auto narrow = allow_narrow && std::all_of(entries.begin(), entries.end(), [] (float d) {
+                return d >= 0.0f && d <= std::numeric_limits<uint16_t>::max() && std::floor(d) == d;
+            });
+
+            allocate(num_nodes, narrow ? DistanceType::UInt16 : DistanceType::Float32, matrix_layout);
+
+            auto* buffer = const_cast<unsigned char*>(storage.get());
+
+            if(narrow) {
+                std::copy(entries.begin(), entries.end(), reinterpret_cast<uint16_t*>(buffer));
+            } else {
+                std::copy(entries.begin(), entries.end(), reinterpret_cast<float*>(buffer));
+            }
+        }
+
+        void Graph::map(const std::string& filename) {
+            const auto fd = ::open(filename.c_str(), O_RDONLY);
+            if(fd < 0) {
                 std::cerr << "Could not open file " << filename << std::endl;
                 _Exit(1);
             }
 
-            auto num_nodes = 0u;
+            struct stat status{};
+            ::fstat(fd, &status);
+            const auto file_bytes = static_cast<std::size_t>(status.st_size);
+
+            // A shared read-only mapping: all the processes using the file share its pages.
+            auto* base = ::mmap(nullptr, file_bytes, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
 
-            // The first number is the number of nodes.
-            if(!(is >> num_nodes)) {
-                std::cerr << "Could not read the number of nodes from" << filename <<  std::endl;
+            if(base == MAP_FAILED || file_bytes < sizeof(InstanceHeader)) {
+                std::cerr << "Could not map file " << filename << std::endl;
                 _Exit(1);
             }
 
-            if(num_nodes == 0u) {
-                std::cerr << "Graph with 0 nodes? There is an error in " << filename << std::endl;
+            const auto* header = static_cast<const InstanceHeader*>(base);
+            const auto expected_bytes = num_entries(header->num_nodes, header->matrix_layout) * distance_size(header->distance_type);
+
+            if(header->version != instance_version || header->num_nodes == 0u || header->matrix_bytes != expected_bytes ||
+               header->matrix_offset % matrix_alignment != 0u || header->matrix_offset + header->matrix_bytes > file_bytes) {
+                std::cerr << "Invalid or unsupported binary instance file " << filename << std::endl;
                 _Exit(1);
             }
 
-            // All other numbers represent node-to-node distances.
-            distance = std::vector<std::vector<float>>(num_nodes, std::vector<float>(num_nodes, 0));
+            nodes = header->num_nodes;
+            type = header->distance_type;
+            layout = header->matrix_layout;
+            weight = EdgeWeightType::Explicit;
 
-            // The distances are given in lower-triangular matrix.
-            auto dist = 0.0f;
-            auto nread = 0u;
-            for(auto i = 0u; i < num_nodes; i++) {
-                for(auto j = 0u; j <= i; j++) {
-                    float dist = 0.0f;
+            // The matrix is used in place: the mapping lives as long as the last copy of the graph.
+            const auto mapping = std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(base),
+                [file_bytes] (const unsigned char* p) { ::munmap(const_cast<unsigned char*>(p), file_bytes); });
+            storage = std::shared_ptr<const unsigned char>(mapping, mapping.get() + header->matrix_offset);
+        }
 
-                    if(!(is >> dist)) {
-                        std::cerr << "Could not read distance (" << i << "," << j << ") from " << filename << std::endl;
-                        _Exit(1);
-                    }
+        std::size_t Graph::matrix_bytes() const {
+            if(weight != EdgeWeightType::Explicit) { return 0u; }
+            return num_entries(nodes, layout) * distance_size(type);
+        }
 
-                    distance[i][j] = dist;
-                    distance[j][i] = dist;
-                    ++nread;
-                }
+        float Graph::tour_cost(const std::vector<uint32_t>& tour) const {
+            assert(tour.size() == nodes);
+
+            if(weight != EdgeWeightType::Explicit) {
+                return static_cast<float>(distance::tour_cost(xs.data(), ys.data(), tour.data(), nodes, weight));
             }
 
-            if(nread != num_nodes * (num_nodes + 1) / 2) {
-                std::cerr << "Expected to read " << num_nodes * (num_nodes + 1) / 2 << " distances, read " << nread << std::endl;
-                _Exit(1);
+            const auto* data = storage.get();
+
+            if(type == DistanceType::UInt16) {
+                const auto* distance = reinterpret_cast<const uint16_t*>(data);
+                return (layout == MatrixLayout::Full) ? tour_cost_of<uint16_t, MatrixLayout::Full>(distance, nodes, tour) :
+                                                        tour_cost_of<uint16_t, MatrixLayout::PackedSymmetric>(distance, nodes, tour);
+            } else {
+                const auto* distance = reinterpret_cast<const float*>(data);
+                return (layout == MatrixLayout::Full) ? tour_cost_of<float, MatrixLayout::Full>(distance, nodes, tour) :
+                                                        tour_cost_of<float, MatrixLayout::PackedSymmetric>(distance, nodes, tour);
             }
         }
+
+        Graph::Graph(const std::vector<std::vector<float>>& distance, bool allow_narrow) {
+            const auto n = static_cast<uint32_t>(distance.size());
+
+            // Check that the matrix is square.
+            assert(std::all_of(distance.begin(), distance.end(), [&] (const auto& row) { return row.size() == distance.size(); }));
+
+            auto symmetric = true;
+            for(auto i = 0u; i < n && symmetric; i++) {
+                for(auto j = 0u; j < i && symmetric; j++) { symmetric = (distance[i][j] == distance[j][i]); }
+            }
+
+            auto entries = std::vector<float>();
+            entries.reserve(num_entries(n, symmetric ? MatrixLayout::PackedSymmetric : MatrixLayout::Full));
+
+            for(auto i = 0u; i < n; i++) {
+                const auto row_end = symmetric ? i + 1u : n;
+                entries.insert(entries.end(), distance[i].begin(), distance[i].begin() + row_end);
+            }
+
+            store(n, symmetric ? MatrixLayout::PackedSymmetric : MatrixLayout::Full, entries, allow_narrow);
+        }
+
+        Graph::Graph(std::vector<double> x, std::vector<double> y, EdgeWeightType type) :
+            nodes{static_cast<uint32_t>(x.size())}, type{DistanceType::Float32}, layout{MatrixLayout::Full},
+            weight{type}, xs{std::move(x)}, ys{std::move(y)}
+        {
+            assert(weight != EdgeWeightType::Explicit);
+            assert(xs.size() == ys.size());
+
+            if(weight == EdgeWeightType::Geographical) {
+                std::transform(xs.begin(), xs.end(), xs.begin(), distance::geographical_radians);
+                std::transform(ys.begin(), ys.end(), ys.begin(), distance::geographical_radians);
+            }
+        }
+
+        Graph::Graph(std::string filename, bool allow_narrow) {
+            if(is_binary_instance(filename)) {
+                map(filename);
+                return;
+            }
+
+            auto instance = read_text_instance(filename);
+
+            if(instance.weight_type != EdgeWeightType::Explicit) {
+                *this = Graph{std::move(instance.x), std::move(instance.y), instance.weight_type};
+                return;
+            }
+
+            store(instance.num_nodes, instance.layout, instance.entries, allow_narrow);
+        }
     }
 }
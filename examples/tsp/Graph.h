@@ -5,51 +5,203 @@
 #ifndef RKBGA_GRAPH_H
 #define RKBGA_GRAPH_H
 
+#include <string>
 #include <vector>
+#include <memory>
 #include <cstdint>
+#include <cstdlib>
 #include <cassert>
 #include <algorithm>
+#include "DistanceKernels.h"
 
 namespace bga {
     namespace tsp {
+        /**
+         * Type of the entries of a distance matrix.
+         */
+        enum class DistanceType : uint32_t {
+            /**
+             * Single-precision floats.
+             */
+            Float32,
+
+            /**
+             * 16-bit unsigned integers, for integral distances up to 65535.
+             */
+            UInt16
+        };
+
+        /**
+         * How the entries of a distance matrix are laid out.
+         */
+        enum class MatrixLayout : uint32_t {
+            /**
+             * All rows, one after the other.
+             */
+            Full,
+
+            /**
+             * Lower triangle (diagonal included) of a symmetric matrix, one row after the other.
+             */
+            PackedSymmetric
+        };
+
         /**
          * This class models a simple graph, as a square distance matrix.
+         * The matrix is stored in a single contiguous, cache-line aligned buffer; symmetric matrices
+         * only store their lower triangle, and integral distances are stored as 16-bit integers
+         * when they fit, which cuts the memory used by a matrix by up to four times.
+         * Alternatively, the graph can store the coordinates of its nodes, and compute distances on
+         * demand (see \file DistanceKernels.h), which makes graphs with 100k nodes and more practical.
          */
         class Graph {
             /**
-             * Distance matrix.
+             * Number of nodes.
              */
-            std::vector<std::vector<float>> distance;
+            uint32_t nodes;
+
+            /**
+             * Type of the distances.
+             */
+            DistanceType type;
+
+            /**
+             * Layout of the distance matrix.
+             */
+            MatrixLayout layout;
+
+            /**
+             * How distances are obtained: from the matrix, or from the coordinates.
+             */
+            EdgeWeightType weight;
+
+            /**
+             * Coordinates of the nodes (in radians, for EdgeWeightType::Geographical), if distances are computed from them.
+             */
+            std::vector<double> xs;
+            std::vector<double> ys;
+
+            /**
+             * Buffer holding the distance matrix: either allocated, or mapped from a binary instance file.
+             * It is shared by the copies of the graph.
+             */
+            std::shared_ptr<const unsigned char> storage;
+
+            /**
+             * Position of the distance between two nodes in the buffer.
+             */
+            std::size_t cell(uint32_t i, uint32_t j) const {
+                if(layout == MatrixLayout::Full) { return static_cast<std::size_t>(i) * nodes + j; }
+                if(i < j) { std::swap(i, j); }
+                return static_cast<std::size_t>(i) * (i + 1u) / 2u + j;
+            }
+
+            /**
+             * Allocates the buffer for a matrix of the given number of nodes, type and layout.
+             */
+            void allocate(uint32_t num_nodes, DistanceType distance_type, MatrixLayout matrix_layout);
+
+            /**
+             * Stores a matrix given by its entries in the layout's order, choosing the narrowest type which
+             * represents them exactly (unless \param allow_narrow is false).
+             */
+            void store(uint32_t num_nodes, MatrixLayout matrix_layout, const std::vector<float>& entries, bool allow_narrow);
+
+            /**
+             * Maps the distance matrix of a binary instance file (see \file InstanceFile.h) into memory.
+             */
+            void map(const std::string& filename);
 
         public:
             /**
              * Directly build the graph from a distance matrix.
-             * @param distance  Square distance matrix.
-             * @return          The corresponding Graph.
+             * @param distance      Square distance matrix.
+             * @param allow_narrow  Whether integral distances may be stored as 16-bit integers.
+             * @return              The corresponding Graph.
              */
-            explicit Graph(std::vector<std::vector<float>> distance) : distance{distance} {
-                // Check that the matrix is square.
-                assert(std::all_of(distance.begin(), distance.end(), [&] (const auto& row) { return row.size() == distance.size(); }));
-            }
+            explicit Graph(const std::vector<std::vector<float>>& distance, bool allow_narrow = true);
 
             /**
-             * Builds a graph from a TSPLIB instance file.
-             * @param filename  The TSPLIB instance file name.
-             * @return          The corresponding Graph.
+             * Build the graph from the coordinates of its nodes; distances are computed on demand.
+             * @param x     First coordinate of each node (latitude, in DDD.MM format, for EdgeWeightType::Geographical).
+             * @param y     Second coordinate of each node (longitude, in DDD.MM format, for EdgeWeightType::Geographical).
+             * @param type  How distances are computed from the coordinates; must not be EdgeWeightType::Explicit.
+             * @return      The corresponding Graph.
              */
-            explicit Graph(std::string filename);
+            Graph(std::vector<double> x, std::vector<double> y, EdgeWeightType type);
+
+            /**
+             * Builds a graph from an instance file. Binary instance files (see \file InstanceFile.h) are
+             * memory-mapped, without copying them; text files, in the plain or TSPLIB format, are parsed.
+             * @param filename      The instance file name.
+             * @param allow_narrow  Whether integral distances read from a text file may be stored as 16-bit integers.
+             * @return              The corresponding Graph.
+             */
+            explicit Graph(std::string filename, bool allow_narrow = true);
 
             /**
              * Number of nodes in the graph.
              */
-            uint32_t num_nodes() const { return distance.size(); }
+            uint32_t num_nodes() const { return nodes; }
+
+            /**
+             * Type of the stored distances.
+             */
+            DistanceType distance_type() const { return type; }
+
+            /**
+             * Layout of the stored distance matrix.
+             */
+            MatrixLayout matrix_layout() const { return layout; }
+
+            /**
+             * How distances are obtained; anything but EdgeWeightType::Explicit means that they are computed from coordinates.
+             */
+            EdgeWeightType weight_type() const { return weight; }
+
+            /**
+             * Whether distances are monotone in the planar Euclidean distance between the coordinates,
+             * e.g. so that nearest neighbours can be found with a spatial index.
+             */
+            bool has_planar_coordinates() const {
+                return weight == EdgeWeightType::Euclidean2D || weight == EdgeWeightType::Ceil2D || weight == EdgeWeightType::Att;
+            }
+
+            /**
+             * Coordinates of the nodes, if distances are computed from them (in radians, for EdgeWeightType::Geographical).
+             */
+            const std::vector<double>& x_coordinates() const { return xs; }
+            const std::vector<double>& y_coordinates() const { return ys; }
+
+            /**
+             * Number of bytes used by the distance matrix (0 if distances are computed from coordinates).
+             */
+            std::size_t matrix_bytes() const;
+
+            /**
+             * The raw distance matrix, laid out as given by \fn matrix_layout.
+             */
+            const void* matrix_data() const { return storage.get(); }
 
             /**
              * Get the distance between two nodes.
              * @param i First node.
              * @param j Second node.
              */
-            float get_distance(uint32_t i, uint32_t j) const;
+            float get_distance(uint32_t i, uint32_t j) const {
+                assert(i < nodes && j < nodes);
+                if(weight != EdgeWeightType::Explicit) { return static_cast<float>(distance::between(xs[i], ys[i], xs[j], ys[j], weight)); }
+
+                const auto k = cell(i, j);
+                if(type == DistanceType::UInt16) { return reinterpret_cast<const uint16_t*>(storage.get())[k]; }
+                return reinterpret_cast<const float*>(storage.get())[k];
+            }
+
+            /**
+             * Get the cost of a tour, i.e. of the closed walk visiting the nodes in the given order.
+             * @param tour  A permutation of the nodes.
+             */
+            float tour_cost(const std::vector<uint32_t>& tour) const;
         };
     }
 }
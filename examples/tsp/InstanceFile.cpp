@@ -0,0 +1,253 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <cctype>
+#include <cstring>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "InstanceFile.h"
+
+namespace bga {
+    namespace tsp {
+        namespace {
+            /**
+             * Reads numbers and words from a text buffer, separated by white space (and, for keywords, colons).
+             */
+            class Scanner {
+                const char* position;
+                const char* end;
+
+                void skip_blanks() {
+                    while(position < end && (std::isspace(static_cast<unsigned char>(*position)) || *position == ':')) { ++position; }
+                }
+
+            public:
+                Scanner(const char* begin, const char* end) : position{begin}, end{end} {}
+
+                template<class Number>
+                bool number(Number& value) {
+                    skip_blanks();
+                    const auto result = std::from_chars(position, end, value);
+                    if(result.ec != std::errc{}) { return false; }
+                    position = result.ptr;
+                    return true;
+                }
+
+                bool word(std::string& value) {
+                    skip_blanks();
+                    const auto begin = position;
+                    while(position < end && !std::isspace(static_cast<unsigned char>(*position)) && *position != ':') { ++position; }
+                    value.assign(begin, position);
+                    return !value.empty();
+                }
+
+                std::string rest_of_line() {
+                    while(position < end && (*position == ' ' || *position == '\t' || *position == ':')) { ++position; }
+                    const auto begin = position;
+                    while(position < end && *position != '\n' && *position != '\r') { ++position; }
+                    auto line = std::string(begin, position);
+                    while(!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) { line.pop_back(); }
+                    return line;
+                }
+
+                bool starts_with_number() {
+                    skip_blanks();
+                    return position < end && std::isdigit(static_cast<unsigned char>(*position));
+                }
+            };
+
+            [[noreturn]] void fail(const std::string& message) {
+                std::cerr << message << std::endl;
+                _Exit(1);
+            }
+
+            std::size_t packed_index(uint32_t i, uint32_t j) {
+                if(i < j) { std::swap(i, j); }
+                return static_cast<std::size_t>(i) * (i + 1u) / 2u + j;
+            }
+
+            /**
+             * Reads \param count distances, exiting with an error message if there are not enough.
+             */
+            std::vector<float> read_distances(Scanner& scanner, std::size_t count, const std::string& filename) {
+                auto distances = std::vector<float>(count);
+                for(auto& distance : distances) {
+                    if(!scanner.number(distance)) { fail("Expected " + std::to_string(count) + " distances in " + filename); }
+                }
+                return distances;
+            }
+
+            /**
+             * Reads the plain format: the number of nodes, then the lower-triangular matrix.
+             */
+            TextInstance read_plain_instance(Scanner& scanner, const std::string& filename) {
+                auto num_nodes = 0u;
+
+                if(!scanner.number(num_nodes)) { fail("Could not read the number of nodes from " + filename); }
+                if(num_nodes == 0u) { fail("Graph with 0 nodes? There is an error in " + filename); }
+
+                const auto count = static_cast<std::size_t>(num_nodes) * (num_nodes + 1u) / 2u;
+                return TextInstance{num_nodes, EdgeWeightType::Explicit, MatrixLayout::PackedSymmetric, read_distances(scanner, count, filename), {}, {}};
+            }
+
+            /**
+             * Reads the NODE_COORD_SECTION of a TSPLIB file (one line per node, with its identifier and coordinates).
+             */
+            TextInstance read_coordinates(Scanner& scanner, uint32_t num_nodes, EdgeWeightType weight_type, const std::string& filename) {
+                auto instance = TextInstance{num_nodes, weight_type, MatrixLayout::Full, {}, std::vector<double>(num_nodes), std::vector<double>(num_nodes)};
+
+                for(auto i = 0u; i < num_nodes; i++) {
+                    auto id = 0u;
+                    if(!scanner.number(id) || !scanner.number(instance.x[i]) || !scanner.number(instance.y[i])) {
+                        fail("Could not read the coordinates of node " + std::to_string(i + 1u) + " from " + filename);
+                    }
+                }
+
+                return instance;
+            }
+
+            /**
+             * Reads a TSPLIB file, with explicit edge weights or node coordinates.
+             */
+            TextInstance read_tsplib_instance(Scanner& scanner, const std::string& filename) {
+                auto num_nodes = 0u;
+                auto weight_type = std::string{};
+                auto weight_format = std::string{};
+                auto keyword = std::string{};
+
+                while(scanner.word(keyword)) {
+                    if(keyword == "EDGE_WEIGHT_SECTION" || keyword == "NODE_COORD_SECTION") { break; }
+                    if(keyword == "EOF") { fail("No EDGE_WEIGHT_SECTION nor NODE_COORD_SECTION in " + filename); }
+
+                    const auto value = scanner.rest_of_line();
+
+                    if(keyword == "DIMENSION") { num_nodes = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)); }
+                    else if(keyword == "EDGE_WEIGHT_TYPE") { weight_type = value; }
+                    else if(keyword == "EDGE_WEIGHT_FORMAT") { weight_format = value; }
+                }
+
+                if(num_nodes == 0u) { fail("Missing or zero DIMENSION in " + filename); }
+
+                if(keyword == "NODE_COORD_SECTION") {
+                    if(weight_type == "EUC_2D") { return read_coordinates(scanner, num_nodes, EdgeWeightType::Euclidean2D, filename); }
+                    if(weight_type == "CEIL_2D") { return read_coordinates(scanner, num_nodes, EdgeWeightType::Ceil2D, filename); }
+                    if(weight_type == "GEO") { return read_coordinates(scanner, num_nodes, EdgeWeightType::Geographical, filename); }
+                    if(weight_type == "ATT") { return read_coordinates(scanner, num_nodes, EdgeWeightType::Att, filename); }
+                }
+
+                if(weight_type != "EXPLICIT" || keyword != "EDGE_WEIGHT_SECTION") {
+                    fail("Unsupported EDGE_WEIGHT_TYPE '" + weight_type + "' in " + filename);
+                }
+
+                const auto n = static_cast<std::size_t>(num_nodes);
+                auto packed = std::vector<float>(n * (n + 1u) / 2u, 0.0f);
+
+                if(weight_format == "FULL_MATRIX") {
+                    auto full = read_distances(scanner, n * n, filename);
+
+                    for(auto i = 0u; i < num_nodes; i++) {
+                        for(auto j = 0u; j < i; j++) {
+                            if(full[i * n + j] != full[j * n + i]) { return TextInstance{num_nodes, EdgeWeightType::Explicit, MatrixLayout::Full, std::move(full), {}, {}}; }
+                        }
+                    }
+
+                    for(auto i = 0u; i < num_nodes; i++) {
+                        for(auto j = 0u; j <= i; j++) { packed[packed_index(i, j)] = full[i * n + j]; }
+                    }
+                } else if(weight_format == "LOWER_DIAG_ROW") {
+                    packed = read_distances(scanner, packed.size(), filename);
+                } else if(weight_format == "LOWER_ROW" || weight_format == "UPPER_ROW" || weight_format == "UPPER_DIAG_ROW") {
+                    const auto lower = (weight_format == "LOWER_ROW");
+                    const auto diagonal = (weight_format == "UPPER_DIAG_ROW");
+
+                    for(auto i = 0u; i < num_nodes; i++) {
+                        const auto first = lower ? 0u : (diagonal ? i : i + 1u);
+                        const auto last = lower ? i : num_nodes;
+
+                        for(auto j = first; j < last; j++) {
+                            if(!scanner.number(packed[packed_index(i, j)])) { fail("Not enough distances in " + filename); }
+                        }
+                    }
+                } else {
+                    fail("Unsupported EDGE_WEIGHT_FORMAT '" + weight_format + "' in " + filename);
+                }
+
+                return TextInstance{num_nodes, EdgeWeightType::Explicit, MatrixLayout::PackedSymmetric, std::move(packed), {}, {}};
+            }
+        }
+
+        uint64_t matrix_checksum(const void* data, std::size_t bytes) {
+            // FNV-1a-style mixing of 64-bit words, with a final avalanche.
+            const auto* p = static_cast<const unsigned char*>(data);
+            auto h = 0xCBF29CE484222325ull ^ static_cast<uint64_t>(bytes);
+
+            auto i = std::size_t{0};
+            for(; i + 8u <= bytes; i += 8u) {
+                auto word = uint64_t{0};
+                std::memcpy(&word, p + i, 8u);
+                h = (h ^ word) * 0x100000001B3ull;
+                h ^= h >> 29;
+            }
+            for(; i < bytes; i++) { h = (h ^ p[i]) * 0x100000001B3ull; }
+
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            return h ^ (h >> 33);
+        }
+
+        bool is_binary_instance(const std::string& filename) {
+            auto is = std::ifstream(filename, std::ios::binary);
+            char magic[sizeof(instance_magic)] = {};
+            is.read(magic, sizeof(magic));
+            return is && std::memcmp(magic, instance_magic, sizeof(magic)) == 0;
+        }
+
+        TextInstance read_text_instance(const std::string& filename) {
+            auto is = std::ifstream(filename, std::ios::binary);
+            if(is.fail()) { fail("Could not open file " + filename); }
+
+            // Parsing from memory is much faster than extracting numbers from the stream.
+            const auto text = std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+            auto scanner = Scanner{text.data(), text.data() + text.size()};
+
+            return scanner.starts_with_number() ? read_plain_instance(scanner, filename) : read_tsplib_instance(scanner, filename);
+        }
+
+        void write_binary_instance(const Graph& graph, const std::string& filename) {
+            if(graph.weight_type() != EdgeWeightType::Explicit) { fail("Only graphs with a distance matrix can be written to " + filename); }
+
+            auto header = InstanceHeader{};
+            std::memcpy(header.magic, instance_magic, sizeof(instance_magic));
+            header.version = instance_version;
+            header.num_nodes = graph.num_nodes();
+            header.distance_type = graph.distance_type();
+            header.matrix_layout = graph.matrix_layout();
+            header.matrix_offset = sizeof(InstanceHeader);
+            header.matrix_bytes = graph.matrix_bytes();
+            header.checksum = matrix_checksum(graph.matrix_data(), graph.matrix_bytes());
+
+            auto os = std::ofstream(filename, std::ios::binary | std::ios::trunc);
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            os.write(static_cast<const char*>(graph.matrix_data()), static_cast<std::streamsize>(graph.matrix_bytes()));
+
+            if(!os) { fail("Could not write file " + filename); }
+        }
+
+        bool verify_binary_instance(const std::string& filename) {
+            auto is = std::ifstream(filename, std::ios::binary);
+            auto header = InstanceHeader{};
+
+            if(!is.read(reinterpret_cast<char*>(&header), sizeof(header))) { return false; }
+            if(std::memcmp(header.magic, instance_magic, sizeof(instance_magic)) != 0 || header.version != instance_version) { return false; }
+
+            is.seekg(static_cast<std::streamoff>(header.matrix_offset));
+            auto matrix = std::vector<char>(header.matrix_bytes);
+            if(!is.read(matrix.data(), static_cast<std::streamsize>(matrix.size()))) { return false; }
+
+            return matrix_checksum(matrix.data(), matrix.size()) == header.checksum;
+        }
+    }
+}
@@ -0,0 +1,121 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_INSTANCEFILE_H
+#define RKBGA_INSTANCEFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+
+namespace bga {
+    namespace tsp {
+        /**
+         * Binary instance files hold a distance matrix exactly as \class Graph stores it in memory,
+         * so that it can be memory-mapped and used without parsing nor copying it; processes mapping
+         * the same file share the same copy in the page cache. The file starts with an \class InstanceHeader,
+         * and the matrix starts at a cache-line aligned offset. Numbers are stored in the byte order
+         * of the machine which wrote the file.
+         */
+        struct InstanceHeader {
+            /**
+             * Always \var instance_magic.
+             */
+            char magic[8];
+
+            /**
+             * Version of the format; always \var instance_version.
+             */
+            uint32_t version;
+
+            /**
+             * Number of nodes.
+             */
+            uint32_t num_nodes;
+
+            /**
+             * Type of the distances.
+             */
+            DistanceType distance_type;
+
+            /**
+             * Layout of the distance matrix.
+             */
+            MatrixLayout matrix_layout;
+
+            /**
+             * Offset, from the start of the file, of the matrix.
+             */
+            uint64_t matrix_offset;
+
+            /**
+             * Size of the matrix, in bytes.
+             */
+            uint64_t matrix_bytes;
+
+            /**
+             * Checksum of the matrix (see \fn matrix_checksum).
+             */
+            uint64_t checksum;
+
+            /**
+             * Unused, zeroed.
+             */
+            unsigned char reserved[16];
+        };
+
+        static_assert(sizeof(InstanceHeader) == 64u, "The matrix must start on a cache line");
+
+        constexpr char instance_magic[8] = {'R', 'K', 'B', 'G', 'A', 'T', 'S', 'P'};
+        constexpr uint32_t instance_version = 1u;
+
+        /**
+         * An instance read from a text file: either the entries of a distance matrix, in the order
+         * given by the layout, or the coordinates of the nodes.
+         */
+        struct TextInstance {
+            uint32_t num_nodes;
+            EdgeWeightType weight_type;
+            MatrixLayout layout;
+            std::vector<float> entries;
+            std::vector<double> x;
+            std::vector<double> y;
+        };
+
+        /**
+         * Checksum of the bytes of a matrix.
+         */
+        uint64_t matrix_checksum(const void* data, std::size_t bytes);
+
+        /**
+         * Whether a file is a binary instance file (i.e., starts with \var instance_magic).
+         */
+        bool is_binary_instance(const std::string& filename);
+
+        /**
+         * Reads a text instance file, either in the plain format (the number of nodes, followed by the
+         * lower-triangular distance matrix, diagonal included) or in the TSPLIB format, with explicit
+         * edge weights (EDGE_WEIGHT_FORMAT: FULL_MATRIX, LOWER_DIAG_ROW, LOWER_ROW, UPPER_ROW or UPPER_DIAG_ROW)
+         * or with node coordinates (EDGE_WEIGHT_TYPE: EUC_2D, CEIL_2D, GEO or ATT).
+         * Exits with an error message if the file cannot be read.
+         */
+        TextInstance read_text_instance(const std::string& filename);
+
+        /**
+         * Writes the distance matrix of a graph to a binary instance file; graphs whose distances
+         * are computed from coordinates are not supported.
+         * Exits with an error message if the file cannot be written.
+         */
+        void write_binary_instance(const Graph& graph, const std::string& filename);
+
+        /**
+         * Checks the header of a binary instance file against its size, and the checksum of its matrix.
+         */
+        bool verify_binary_instance(const std::string& filename);
+    }
+}
+
+#endif //RKBGA_INSTANCEFILE_H
@@ -0,0 +1,213 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <numeric>
+#include <algorithm>
+#include "LocalSearch.h"
+#include "SpatialGrid.h"
+
+namespace bga {
+    namespace tsp {
+        namespace {
+            /**
+             * Moves with a smaller gain are not applied, so that rounding errors cannot make the search cycle.
+             */
+            constexpr float min_gain = 1e-4f;
+
+            uint32_t next_position(uint32_t i, uint32_t n) { return (i + 1u == n) ? 0u : i + 1u; }
+            uint32_t previous_position(uint32_t i, uint32_t n) { return (i == 0u) ? n - 1u : i - 1u; }
+
+            /**
+             * Reverses the nodes in positions i, i+1, ..., j (mod n) of a tour. If that segment is
+             * longer than half the tour, the rest of the tour is reversed instead, which gives the same
+             * tour in the opposite direction.
+             */
+            void reverse(std::vector<uint32_t>& tour, std::vector<uint32_t>& position, uint32_t i, uint32_t j) {
+                const auto n = static_cast<uint32_t>(tour.size());
+                auto length = (j + n - i) % n + 1u;
+
+                if(2u * length > n) {
+                    const auto complement_begin = next_position(j, n);
+                    j = previous_position(i, n);
+                    i = complement_begin;
+                    length = n - length;
+                }
+
+                for(auto k = 0u; k < length / 2u; k++) {
+                    std::swap(tour[i], tour[j]);
+                    position[tour[i]] = i;
+                    position[tour[j]] = j;
+                    i = next_position(i, n);
+                    j = previous_position(j, n);
+                }
+            }
+        }
+
+        LocalSearch::LocalSearch(const Graph& graph, uint32_t num_neighbours) :
+            graph{graph}, num_neighbours{std::min(num_neighbours, graph.num_nodes() - 1u)}
+        {
+            const auto n = graph.num_nodes();
+            neighbours.reserve(static_cast<std::size_t>(n) * this->num_neighbours);
+
+            // With planar coordinates, a spatial index avoids looking at all pairs of nodes.
+            if(graph.has_planar_coordinates()) {
+                const auto grid = SpatialGrid{graph.x_coordinates(), graph.y_coordinates()};
+                auto nearest = std::vector<uint32_t>();
+
+                for(auto i = 0u; i < n; i++) {
+                    grid.nearest(i, this->num_neighbours, nearest);
+                    neighbours.insert(neighbours.end(), nearest.begin(), nearest.end());
+                }
+
+                return;
+            }
+
+            auto others = std::vector<uint32_t>(n);
+
+            for(auto i = 0u; i < n; i++) {
+                std::iota(others.begin(), others.end(), 0u);
+                std::swap(others[i], others.back());
+
+                std::partial_sort(others.begin(), others.begin() + this->num_neighbours, others.end() - 1, [&] (auto j, auto k) {
+                    return graph.get_distance(i, j) < graph.get_distance(i, k);
+                });
+
+                neighbours.insert(neighbours.end(), others.begin(), others.begin() + this->num_neighbours);
+            }
+        }
+
+        bool LocalSearch::two_opt(std::vector<uint32_t>& tour, std::vector<uint32_t>& position, uint32_t node, std::vector<uint32_t>& touched) const {
+            const auto n = static_cast<uint32_t>(tour.size());
+            const auto i = position[node];
+            const auto succ = tour[next_position(i, n)];
+            const auto pred = tour[previous_position(i, n)];
+
+            for(auto k = 0u; k < num_neighbours; k++) {
+                const auto other = neighbours[node * num_neighbours + k];
+                const auto j = position[other];
+                const auto new_edge = graph.get_distance(node, other);
+
+                // Replace edges (node, succ) and (other, other's succ) with (node, other) and (succ, other's succ).
+                const auto other_succ = tour[next_position(j, n)];
+                if(other != succ && other_succ != node) {
+                    const auto gain = graph.get_distance(node, succ) + graph.get_distance(other, other_succ) -
+                                      new_edge - graph.get_distance(succ, other_succ);
+
+                    if(gain > min_gain) {
+                        reverse(tour, position, next_position(i, n), j);
+                        touched.insert(touched.end(), {node, succ, other, other_succ});
+                        return true;
+                    }
+                }
+
+                // Replace edges (pred, node) and (other's pred, other) with (node, other) and (pred, other's pred).
+                const auto other_pred = tour[previous_position(j, n)];
+                if(other != pred && other_pred != node) {
+                    const auto gain = graph.get_distance(pred, node) + graph.get_distance(other_pred, other) -
+                                      new_edge - graph.get_distance(pred, other_pred);
+
+                    if(gain > min_gain) {
+                        reverse(tour, position, i, previous_position(j, n));
+                        touched.insert(touched.end(), {node, pred, other, other_pred});
+                        return true;
+                    }
+                }
+
+                // Neighbours are sorted: farther ones cannot give a shorter new edge.
+                if(new_edge >= graph.get_distance(node, succ) && new_edge >= graph.get_distance(pred, node)) { break; }
+            }
+
+            return false;
+        }
+
+        bool LocalSearch::or_opt(std::vector<uint32_t>& tour, std::vector<uint32_t>& position, uint32_t node, std::vector<uint32_t>& touched) const {
+            const auto n = static_cast<uint32_t>(tour.size());
+            const auto i = position[node];
+
+            for(auto length = 1u; length <= 3u && length + 3u <= n; length++) {
+                const auto first = node;
+                const auto last = tour[(i + length - 1u) % n];
+                const auto pred = tour[previous_position(i, n)];
+                const auto succ = tour[(i + length) % n];
+                const auto removal_gain = graph.get_distance(pred, first) + graph.get_distance(last, succ) - graph.get_distance(pred, succ);
+
+                if(removal_gain <= min_gain) { continue; }
+
+                auto in_segment = [&] (uint32_t v) { return (position[v] + n - i) % n < length; };
+
+                for(const auto endpoint : {first, last}) {
+                    for(auto k = 0u; k < num_neighbours; k++) {
+                        const auto other = neighbours[endpoint * num_neighbours + k];
+                        if(graph.get_distance(endpoint, other) >= removal_gain) { break; }
+                        if(in_segment(other)) { continue; }
+
+                        // Try to insert the segment on both sides of the neighbour.
+                        for(const auto before : {true, false}) {
+                            const auto u = before ? tour[previous_position(position[other], n)] : other;
+                            const auto v = before ? other : tour[next_position(position[other], n)];
+                            if(in_segment(u) || in_segment(v)) { continue; }
+
+                            const auto forward = graph.get_distance(u, first) + graph.get_distance(last, v);
+                            const auto backward = graph.get_distance(u, last) + graph.get_distance(first, v);
+                            const auto gain = removal_gain - (std::min(forward, backward) - graph.get_distance(u, v));
+
+                            if(gain <= min_gain) { continue; }
+
+                            // Bring the segment to the front of the tour, then move it right after u.
+                            std::rotate(tour.begin(), tour.begin() + i, tour.end());
+                            const auto u_position = (position[u] + n - i) % n;
+                            std::rotate(tour.begin(), tour.begin() + length, tour.begin() + u_position + 1u);
+
+                            if(backward < forward) {
+                                std::reverse(tour.begin() + u_position + 1u - length, tour.begin() + u_position + 1u);
+                            }
+
+                            for(auto p = 0u; p < n; p++) { position[tour[p]] = p; }
+
+                            touched.insert(touched.end(), {first, last, pred, succ, u, v});
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        void LocalSearch::improve(std::vector<uint32_t>& tour) const {
+            const auto n = static_cast<uint32_t>(tour.size());
+            assert(n == graph.num_nodes());
+
+            if(n < 5u) { return; }
+
+            auto position = std::vector<uint32_t>(n);
+            for(auto p = 0u; p < n; p++) { position[tour[p]] = p; }
+
+            // Nodes whose don't-look bit is off, in a circular queue.
+            auto queue = std::vector<uint32_t>(tour.begin(), tour.end());
+            auto queued = std::vector<char>(n, 1);
+            auto head = 0u;
+            auto queue_size = n;
+            auto touched = std::vector<uint32_t>();
+
+            while(queue_size > 0u) {
+                const auto node = queue[head];
+                head = next_position(head, n);
+                --queue_size;
+                queued[node] = 0;
+
+                touched.clear();
+                if(!two_opt(tour, position, node, touched) && !or_opt(tour, position, node, touched)) { continue; }
+
+                // Look again around the endpoints of the changed edges.
+                for(const auto t : touched) {
+                    if(queued[t]) { continue; }
+                    queue[(head + queue_size) % n] = t;
+                    ++queue_size;
+                    queued[t] = 1;
+                }
+            }
+        }
+    }
+}
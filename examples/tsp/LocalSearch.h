@@ -0,0 +1,70 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_LOCALSEARCH_H
+#define RKBGA_LOCALSEARCH_H
+
+#include <vector>
+#include <cstdint>
+#include "Graph.h"
+
+namespace bga {
+    namespace tsp {
+        /**
+         * This class improves tours in a \class Graph with 2-opt and Or-opt moves, until no improving
+         * move is left. Only moves which create an edge between a node and one of its nearest
+         * neighbours are tried, and don't-look bits skip the nodes whose surroundings have not
+         * changed since no improving move was found around them.
+         * It can be used concurrently by several threads.
+         */
+        class LocalSearch {
+            /**
+             * The underlying graph.
+             */
+            const Graph& graph;
+
+            /**
+             * Number of candidate neighbours of each node.
+             */
+            uint32_t num_neighbours;
+
+            /**
+             * The candidate neighbours of each node, sorted by increasing distance: the neighbours
+             * of node i are in positions [i * num_neighbours, (i+1) * num_neighbours).
+             */
+            std::vector<uint32_t> neighbours;
+
+            /**
+             * Tries the 2-opt moves which add an edge between the node in a given position and one
+             * of its neighbours, and applies the first improving one.
+             * @return  Whether a move was applied.
+             */
+            bool two_opt(std::vector<uint32_t>& tour, std::vector<uint32_t>& position, uint32_t node, std::vector<uint32_t>& touched) const;
+
+            /**
+             * Tries to move a segment of 1 to 3 nodes, starting at a given node, next to one of
+             * the neighbours of its endpoints (possibly reversing it), and applies the first
+             * improving move.
+             * @return  Whether a move was applied.
+             */
+            bool or_opt(std::vector<uint32_t>& tour, std::vector<uint32_t>& position, uint32_t node, std::vector<uint32_t>& touched) const;
+
+        public:
+            /**
+             * Builds the candidate neighbour lists, with a \class SpatialGrid if the graph has planar coordinates.
+             * @param graph             The graph.
+             * @param num_neighbours    Number of nearest neighbours of each node which are considered.
+             */
+            LocalSearch(const Graph& graph, uint32_t num_neighbours = 10u);
+
+            /**
+             * Improves a tour in place.
+             * @param tour  A permutation of the nodes of the graph.
+             */
+            void improve(std::vector<uint32_t>& tour) const;
+        };
+    }
+}
+
+#endif //RKBGA_LOCALSEARCH_H
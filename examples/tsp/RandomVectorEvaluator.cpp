@@ -3,21 +3,46 @@
 //
 
 #include "RandomVectorEvaluator.h"
+#include "../../src/PermutationEncoder.h"
+#include "../../src/PermutationDecoder.h"
 
 namespace bga {
     namespace tsp {
+        void RandomVectorEvaluator::decode(const bga::RandomVectorIndividual &individual, std::vector<uint32_t>& permutation) const {
+            decode_permutation(individual.data(), individual.size(), permutation);
+        }
+
         float RandomVectorEvaluator::evaluate(const bga::RandomVectorIndividual &individual) const {
-            auto permutation = std::vector<uint32_t>(graph.num_nodes());
-            std::iota(permutation.begin(), permutation.end(), 0u);
-            std::sort(permutation.begin(), permutation.end(), [&] (auto i, auto j) { return individual.component(i) < individual.component(j); });
+            thread_local auto permutation = std::vector<uint32_t>();
+            decode(individual, permutation);
+            return graph.tour_cost(permutation);
+        }
+
+        void RandomVectorEvaluator::evaluate_batch(Span<const bga::RandomVectorIndividual> individuals, Span<float> objvalues) const {
+            assert(individuals.size() == objvalues.size());
 
-            auto cost = 0.0f;
-            for(auto i = 0u; i < permutation.size() - 1; i++) {
-                cost += graph.get_distance(permutation[i], permutation[i+1]);
+            auto permutation = std::vector<uint32_t>(graph.num_nodes());
+            for(auto i = 0u; i < individuals.size(); i++) {
+                decode(individuals[i], permutation);
+                objvalues[i] = graph.tour_cost(permutation);
             }
-            cost += graph.get_distance(permutation[permutation.size() - 1], permutation[0]);
+        }
+
+        float RandomVectorEvaluator::improve(bga::RandomVectorIndividual &individual, float objvalue) const {
+            if(!local_search) { return objvalue; }
+
+            thread_local auto tour = std::vector<uint32_t>();
+            decode(individual, tour);
+            local_search->improve(tour);
+            encode_permutation(tour.data(), graph.num_nodes(), individual.data());
+
+            return graph.tour_cost(tour);
+        }
 
-            return cost;
+        uint64_t RandomVectorEvaluator::hash(const bga::RandomVectorIndividual &individual) const {
+            thread_local auto permutation = std::vector<uint32_t>();
+            decode(individual, permutation);
+            return hash_words(permutation.data(), permutation.size());
         }
     }
-}
\ No newline at end of file
+}
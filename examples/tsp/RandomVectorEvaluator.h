@@ -6,6 +6,9 @@
 #define RKBGA_RANDOMVECTOREVALUATOR_H
 
 #include "Graph.h"
+#include "LocalSearch.h"
+#include "../../src/Hash.h"
+#include "../../src/Span.h"
 #include "../../src/RandomVectorIndividual.h"
 
 namespace bga {
@@ -21,15 +24,57 @@ namespace bga {
              */
             const Graph& graph;
 
+            /**
+             * Local search used to improve individuals, or nullptr if they are not improved.
+             */
+            const LocalSearch* local_search;
+
         public:
             using individual_type = RandomVectorIndividual;
 
-            RandomVectorEvaluator(const Graph& graph) : graph{graph} {}
+            /**
+             * Builds the evaluator.
+             * @param graph         The graph.
+             * @param local_search  Local search used to improve the elite individuals (see \fn improve),
+             *                      or nullptr to leave them as they are.
+             */
+            RandomVectorEvaluator(const Graph& graph, const LocalSearch* local_search = nullptr) :
+                graph{graph}, local_search{local_search} {}
+
+            /**
+             * Decodes an individual into the tour it represents.
+             * @param individual    The individual.
+             * @param permutation   Output: the tour; it is resized to one entry per node.
+             */
+            void decode(const RandomVectorIndividual& individual, std::vector<uint32_t>& permutation) const;
 
             /**
              * Evaluates a \class RandomVectorIndividual.
              */
             float evaluate(const RandomVectorIndividual& individual) const;
+
+            /**
+             * Evaluates a batch of \class RandomVectorIndividual, reusing the same
+             * decoding buffer for all of them.
+             * @param individuals   The individuals to evaluate.
+             * @param objvalues     Output: the cost of each individual's tour.
+             */
+            void evaluate_batch(Span<const RandomVectorIndividual> individuals, Span<float> objvalues) const;
+
+            /**
+             * Improves the tour which a \class RandomVectorIndividual represents with the local search,
+             * if any, and encodes the improved tour back into the individual's chromosome.
+             * @param individual    The individual to improve.
+             * @param objvalue      Its objective value.
+             * @return              The cost of the improved tour.
+             */
+            float improve(RandomVectorIndividual& individual, float objvalue) const;
+
+            /**
+             * Hashes the tour which a \class RandomVectorIndividual represents, so that
+             * individuals decoding to the same tour share the same cache entry.
+             */
+            uint64_t hash(const RandomVectorIndividual& individual) const;
         };
     }
 }
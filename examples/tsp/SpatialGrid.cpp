@@ -0,0 +1,104 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <cmath>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include "SpatialGrid.h"
+
+namespace bga {
+    namespace tsp {
+        SpatialGrid::SpatialGrid(const std::vector<double>& x, const std::vector<double>& y, double points_per_cell) : x{x}, y{y} {
+            assert(x.size() == y.size() && !x.empty());
+
+            const auto n = static_cast<uint32_t>(x.size());
+            const auto [x_low, x_high] = std::minmax_element(x.begin(), x.end());
+            const auto [y_low, y_high] = std::minmax_element(y.begin(), y.end());
+
+            min_x = *x_low;
+            min_y = *y_low;
+
+            // Cells are squares, with points_per_cell points each if the points were spread uniformly.
+            const auto width = std::max(*x_high - min_x, 1e-9);
+            const auto height = std::max(*y_high - min_y, 1e-9);
+            const auto num_cells = std::max(1.0, n / points_per_cell);
+
+            side = std::sqrt(width * height / num_cells);
+            side = std::max(side, std::max(width, height) / num_cells);
+            columns = static_cast<uint32_t>(width / side) + 1u;
+            rows = static_cast<uint32_t>(height / side) + 1u;
+
+            // Counting sort of the points by cell.
+            cell_begin.assign(static_cast<std::size_t>(columns) * rows + 1u, 0u);
+            for(auto i = 0u; i < n; i++) { ++cell_begin[row_of(y[i]) * columns + column_of(x[i]) + 1u]; }
+            for(auto c = 1u; c < cell_begin.size(); c++) { cell_begin[c] += cell_begin[c - 1u]; }
+
+            auto fill = std::vector<uint32_t>(cell_begin.begin(), cell_begin.end() - 1);
+            cell_points.resize(n);
+            for(auto i = 0u; i < n; i++) { cell_points[fill[row_of(y[i]) * columns + column_of(x[i])]++] = i; }
+        }
+
+        uint32_t SpatialGrid::column_of(double coordinate) const {
+            return std::min(static_cast<uint32_t>((coordinate - min_x) / side), columns - 1u);
+        }
+
+        uint32_t SpatialGrid::row_of(double coordinate) const {
+            return std::min(static_cast<uint32_t>((coordinate - min_y) / side), rows - 1u);
+        }
+
+        void SpatialGrid::nearest(uint32_t point, uint32_t how_many, std::vector<uint32_t>& nearest) const {
+            assert(how_many < x.size());
+
+            // Max-heap of the best candidates so far, by (squared distance, index).
+            auto candidates = std::vector<std::pair<double, uint32_t>>();
+            candidates.reserve(how_many + 1u);
+
+            const auto column = static_cast<int64_t>(column_of(x[point]));
+            const auto row = static_cast<int64_t>(row_of(y[point]));
+            const auto max_radius = static_cast<int64_t>(std::max(columns, rows));
+
+            for(auto radius = int64_t{0}; radius <= max_radius; radius++) {
+                // Points outside the rings visited so far are at least this far.
+                const auto bound = (radius - 1) * side;
+                if(candidates.size() == how_many && radius > 0 && bound * bound > candidates.front().first) { break; }
+
+                for(auto r = row - radius; r <= row + radius; r++) {
+                    if(r < 0 || r >= static_cast<int64_t>(rows)) { continue; }
+
+                    // Only the border of the square of cells is new.
+                    const auto step = (r == row - radius || r == row + radius) ? int64_t{1} : std::max(int64_t{1}, 2 * radius);
+
+                    for(auto c = column - radius; c <= column + radius; c += step) {
+                        if(c < 0 || c >= static_cast<int64_t>(columns)) { continue; }
+
+                        const auto cell = static_cast<std::size_t>(r) * columns + static_cast<std::size_t>(c);
+                        for(auto k = cell_begin[cell]; k < cell_begin[cell + 1u]; k++) {
+                            const auto other = cell_points[k];
+                            if(other == point) { continue; }
+
+                            const auto dx = x[other] - x[point];
+                            const auto dy = y[other] - y[point];
+                            const auto candidate = std::make_pair(dx * dx + dy * dy, other);
+
+                            if(candidates.size() < how_many) {
+                                candidates.push_back(candidate);
+                                std::push_heap(candidates.begin(), candidates.end());
+                            } else if(how_many > 0u && candidate < candidates.front()) {
+                                std::pop_heap(candidates.begin(), candidates.end());
+                                candidates.back() = candidate;
+                                std::push_heap(candidates.begin(), candidates.end());
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::sort_heap(candidates.begin(), candidates.end());
+
+            nearest.clear();
+            for(const auto& candidate : candidates) { nearest.push_back(candidate.second); }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_SPATIALGRID_H
+#define RKBGA_SPATIALGRID_H
+
+#include <vector>
+#include <cstdint>
+
+namespace bga {
+    namespace tsp {
+        /**
+         * This class is a uniform grid over planar points, sized so that each cell holds a few points on
+         * average. It finds the nearest neighbours of a point by visiting rings of cells of increasing
+         * radius around it, which takes roughly constant time for uniformly spread points, instead of
+         * scanning all the other points.
+         */
+        class SpatialGrid {
+            /**
+             * Coordinates of the points.
+             */
+            const std::vector<double>& x;
+            const std::vector<double>& y;
+
+            /**
+             * Lower-left corner of the grid.
+             */
+            double min_x, min_y;
+
+            /**
+             * Side of a cell.
+             */
+            double side;
+
+            /**
+             * Number of columns and rows of cells.
+             */
+            uint32_t columns, rows;
+
+            /**
+             * The points in cell c are cell_points[cell_begin[c]], ..., cell_points[cell_begin[c+1] - 1].
+             */
+            std::vector<uint32_t> cell_begin;
+            std::vector<uint32_t> cell_points;
+
+            uint32_t column_of(double coordinate) const;
+            uint32_t row_of(double coordinate) const;
+
+        public:
+            /**
+             * Builds the grid.
+             * @param x                 First coordinate of each point.
+             * @param y                 Second coordinate of each point.
+             * @param points_per_cell   Average number of points per cell.
+             */
+            SpatialGrid(const std::vector<double>& x, const std::vector<double>& y, double points_per_cell = 2.0);
+
+            /**
+             * Finds the nearest points to a given one (excluding itself), by Euclidean distance.
+             * @param point     The point.
+             * @param how_many  Number of neighbours; at most the number of other points.
+             * @param nearest   Output: the neighbours, nearest first (ties broken by index).
+             */
+            void nearest(uint32_t point, uint32_t how_many, std::vector<uint32_t>& nearest) const;
+        };
+    }
+}
+
+#endif //RKBGA_SPATIALGRID_H
@@ -2,25 +2,159 @@
 // Created by alberto on 27/08/16.
 //
 
+#include <array>
+#include <numeric>
+#include <algorithm>
 #include "TranspositionVectorEvaluator.h"
+#include "../../src/PermutationEncoder.h"
 
 namespace bga {
     namespace tsp {
-        float bga::tsp::TranspositionVectorEvaluator::evaluate(const bga::TranspositionVectorIndividual &individual) const {
-            auto permutation = std::vector<uint32_t>(graph.num_nodes());
+        void TranspositionVectorEvaluator::decode(const bga::TranspositionVectorIndividual &individual, std::vector<uint32_t>& permutation) const {
+            permutation.resize(graph.num_nodes());
             std::iota(permutation.begin(), permutation.end(), 0u);
 
             for(auto i = 0u; i < 2 * (graph.num_nodes() - 1); i+= 2) {
                 std::swap(permutation[individual.component(i)], permutation[individual.component(i + 1)]);
             }
+        }
+
+        float TranspositionVectorEvaluator::evaluate(const bga::TranspositionVectorIndividual &individual) const {
+            auto permutation = std::vector<uint32_t>(graph.num_nodes());
+            decode(individual, permutation);
+            return graph.tour_cost(permutation);
+        }
+
+        void TranspositionVectorEvaluator::evaluate_batch(Span<const bga::TranspositionVectorIndividual> individuals, Span<float> objvalues) const {
+            assert(individuals.size() == objvalues.size());
 
-            auto cost = 0.0f;
-            for(auto i = 0u; i < permutation.size() - 1; i++) {
-                cost += graph.get_distance(permutation[i], permutation[i+1]);
+            auto permutation = std::vector<uint32_t>(graph.num_nodes());
+            for(auto i = 0u; i < individuals.size(); i++) {
+                decode(individuals[i], permutation);
+                objvalues[i] = graph.tour_cost(permutation);
             }
-            cost += graph.get_distance(permutation[permutation.size() - 1], permutation[0]);
+        }
+
+        float TranspositionVectorEvaluator::evaluate_delta(const bga::TranspositionVectorIndividual &individual, const bga::TranspositionVectorIndividual &parent,
+                                                           const std::vector<uint32_t>& parent_tour, float parent_cost, Span<const uint32_t> diff) const {
+            assert(parent_tour.size() == graph.num_nodes());
+
+            // Same chromosome, same tour.
+            if(diff.empty()) { return parent_cost; }
+
+            // Indices of the changed pairs, in increasing order.
+            auto pairs = std::array<uint32_t, max_delta_pairs>{};
+            auto num_pairs = 0u;
+
+            for(const auto position : diff) {
+                const auto pair = position / 2u;
+                if(num_pairs > 0u && pairs[num_pairs - 1u] == pair) { continue; }
+                if(num_pairs == max_delta_pairs) { return evaluate(individual); }
+                pairs[num_pairs++] = pair;
+            }
+
+            // With P the parent's tour, changing its k-th transposition t into s gives the tour P B'tsB,
+            // where B is the product of the transpositions after the k-th one, and B' its inverse: only
+            // the positions B'(x), for x an endpoint of t or s, are affected. Changing more pairs, in
+            // increasing order, gives the product of one such permutation per pair.
+            constexpr auto max_points = 4u * max_delta_pairs;
+            auto endpoints = std::array<uint32_t, max_points>{};
+            auto positions = std::array<uint32_t, max_points>{};
+
+            for(auto j = 0u; j < num_pairs; j++) {
+                const auto k = 2u * pairs[j];
+                endpoints[4u * j] = parent.component(k);
+                endpoints[4u * j + 1u] = parent.component(k + 1u);
+                endpoints[4u * j + 2u] = individual.component(k);
+                endpoints[4u * j + 3u] = individual.component(k + 1u);
+            }
+
+            positions = endpoints;
+
+            // Apply B' to the endpoints of each changed pair, i.e. follow them through the parent's later transpositions.
+            const auto num_transpositions = graph.num_nodes() - 1u;
+            auto active = 0u;
+
+            for(auto i = pairs[0] + 1u, next = 0u; i < num_transpositions; i++) {
+                while(next < num_pairs && pairs[next] < i) { active += 4u; ++next; }
+
+                const auto c = parent.component(2u * i);
+                const auto d = parent.component(2u * i + 1u);
+
+                for(auto p = 0u; p < active; p++) {
+                    positions[p] = (positions[p] == c) ? d : ((positions[p] == d) ? c : positions[p]);
+                }
+            }
+
+            // The offspring's node in each affected position x is the parent's node in position
+            // Q_1(...(Q_r(x))), where Q_j maps B'(e) to B'(t(s(e))) for each endpoint e of the j-th pair.
+            const auto num_points = 4u * num_pairs;
+            auto nodes = std::array<uint32_t, max_points>{};
+
+            for(auto p = 0u; p < num_points; p++) {
+                auto y = positions[p];
+
+                for(auto j = num_pairs; j-- > 0u; ) {
+                    const auto* e = endpoints.data() + 4u * j;
+                    const auto* x = positions.data() + 4u * j;
+
+                    for(auto q = 0u; q < 4u; q++) {
+                        if(x[q] != y) { continue; }
+
+                        // Apply s, then t, to the endpoint, and map it back with B'.
+                        auto z = e[q];
+                        z = (z == e[2]) ? e[3] : ((z == e[3]) ? e[2] : z);
+                        z = (z == e[0]) ? e[1] : ((z == e[1]) ? e[0] : z);
+                        for(auto u = 0u; u < 4u; u++) { if(e[u] == z) { y = x[u]; break; } }
+                        break;
+                    }
+                }
+
+                nodes[p] = parent_tour[y];
+            }
+
+            const auto n = graph.num_nodes();
+            const auto node_at = [&] (uint32_t y) {
+                for(auto p = 0u; p < num_points; p++) { if(positions[p] == y) { return nodes[p]; } }
+                return parent_tour[y];
+            };
+
+            // Edges around the affected positions; edge e joins positions e and e+1 (mod n).
+            auto edges = std::array<uint32_t, 2u * max_points>{};
+            for(auto p = 0u; p < num_points; p++) {
+                edges[2u * p] = (positions[p] == 0u) ? n - 1u : positions[p] - 1u;
+                edges[2u * p + 1u] = positions[p];
+            }
+
+            std::sort(edges.begin(), edges.begin() + 2u * num_points);
+            const auto edges_end = std::unique(edges.begin(), edges.begin() + 2u * num_points);
+
+            auto delta = 0.0;
+            for(auto it = edges.begin(); it != edges_end; ++it) {
+                const auto e = *it;
+                const auto f = (e + 1u == n) ? 0u : e + 1u;
+                delta += static_cast<double>(graph.get_distance(node_at(e), node_at(f))) - graph.get_distance(parent_tour[e], parent_tour[f]);
+            }
+
+            return static_cast<float>(parent_cost + delta);
+        }
+
+        float TranspositionVectorEvaluator::improve(bga::TranspositionVectorIndividual &individual, float objvalue) const {
+            if(!local_search) { return objvalue; }
+
+            thread_local auto tour = std::vector<uint32_t>();
+            decode(individual, tour);
+            local_search->improve(tour);
+            encode_transpositions(tour.data(), graph.num_nodes(), individual.data());
+
+            return graph.tour_cost(tour);
+        }
 
-            return cost;
+        uint64_t TranspositionVectorEvaluator::hash(const bga::TranspositionVectorIndividual &individual) const {
+            thread_local auto permutation = std::vector<uint32_t>();
+            permutation.resize(graph.num_nodes());
+            decode(individual, permutation);
+            return hash_words(permutation.data(), permutation.size());
         }
     }
 }
@@ -6,6 +6,9 @@
 #define RKBGA_TRANSPOSITIONVECTOREVALUATOR_H
 
 #include "Graph.h"
+#include "LocalSearch.h"
+#include "../../src/Hash.h"
+#include "../../src/Span.h"
 #include "../../src/TranspositionVectorIndividual.h"
 
 namespace bga {
@@ -21,15 +24,96 @@ namespace bga {
              */
             const Graph& graph;
 
+            /**
+             * Local search used to improve individuals, or nullptr if they are not improved.
+             */
+            const LocalSearch* local_search;
+
+            /**
+             * Maximum number of changed pairs for which \fn evaluate_delta is cheaper than evaluating
+             * the offspring from scratch.
+             */
+            static constexpr uint32_t max_delta_pairs = 4u;
+
         public:
             using individual_type = TranspositionVectorIndividual;
 
-            TranspositionVectorEvaluator(const Graph& graph) : graph{graph} {}
+            /**
+             * The decoded state of an individual is the tour it represents.
+             */
+            using decoded_type = std::vector<uint32_t>;
+
+            /**
+             * Builds the evaluator.
+             * @param graph         The graph.
+             * @param local_search  Local search used to improve the elite individuals (see \fn improve),
+             *                      or nullptr to leave them as they are.
+             */
+            TranspositionVectorEvaluator(const Graph& graph, const LocalSearch* local_search = nullptr) :
+                graph{graph}, local_search{local_search} {}
 
             /**
              * Evaluates a \class TranspositionVectorIndividual.
              */
             float evaluate(const TranspositionVectorIndividual& individual) const;
+
+            /**
+             * Evaluates a batch of \class TranspositionVectorIndividual, reusing the same
+             * decoding buffer for all of them.
+             * @param individuals   The individuals to evaluate.
+             * @param objvalues     Output: the cost of each individual's tour.
+             */
+            void evaluate_batch(Span<const TranspositionVectorIndividual> individuals, Span<float> objvalues) const;
+
+            /**
+             * Decodes an individual into the tour it represents.
+             * @param individual    The individual.
+             * @param permutation   Output: the tour; it is resized to one entry per node.
+             */
+            void decode(const TranspositionVectorIndividual& individual, std::vector<uint32_t>& permutation) const;
+
+            /**
+             * Evaluates an already decoded tour.
+             */
+            float evaluate_decoded(const std::vector<uint32_t>& tour) const { return graph.tour_cost(tour); }
+
+            /**
+             * Evaluates an offspring incrementally from its parent, without decoding it. The tour is the
+             * product of the transpositions, and changing the k-th one only exchanges the nodes in
+             * (at most four) positions, which are found by following the endpoints of the old and new
+             * k-th transposition through the parent's later ones. Therefore only the (at most eight)
+             * edges around each of these positions are looked up in the graph. If more pairs than
+             * \fn max_delta_diff allows changed, the offspring is evaluated from scratch.
+             * @param individual    The offspring.
+             * @param parent        The parent.
+             * @param parent_tour   The tour of the parent.
+             * @param parent_cost   The cost of the parent's tour.
+             * @param diff          Positions in which the offspring's chromosome differs from the parent's.
+             * @return              The cost of the offspring's tour.
+             */
+            float evaluate_delta(const TranspositionVectorIndividual& individual, const TranspositionVectorIndividual& parent,
+                                 const std::vector<uint32_t>& parent_tour, float parent_cost, Span<const uint32_t> diff) const;
+
+            /**
+             * Maximum number of positions in which an offspring can differ from its parent to be
+             * evaluated incrementally, i.e. two per changed pair.
+             */
+            uint32_t max_delta_diff() const { return 2u * max_delta_pairs; }
+
+            /**
+             * Improves the tour which a \class TranspositionVectorIndividual represents with the local search,
+             * if any, and encodes the improved tour back into the individual's chromosome.
+             * @param individual    The individual to improve.
+             * @param objvalue      Its objective value.
+             * @return              The cost of the improved tour.
+             */
+            float improve(TranspositionVectorIndividual& individual, float objvalue) const;
+
+            /**
+             * Hashes the tour which a \class TranspositionVectorIndividual represents, so that
+             * individuals decoding to the same tour share the same cache entry.
+             */
+            uint64_t hash(const TranspositionVectorIndividual& individual) const;
         };
     }
 }
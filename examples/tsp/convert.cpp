@@ -0,0 +1,37 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <string>
+#include <iostream>
+
+#include "Graph.h"
+#include "InstanceFile.h"
+
+/**
+ * Converts a text instance (in the plain or the TSPLIB format) into a binary instance file,
+ * which \class bga::tsp::Graph memory-maps instead of parsing it.
+ * Usage: convert <text instance> <binary instance>
+ */
+int main(int argc, char* argv[]) {
+    using namespace bga::tsp;
+
+    if(argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <text instance> <binary instance>" << std::endl;
+        return 1;
+    }
+
+    const auto graph = Graph{std::string(argv[1])};
+    write_binary_instance(graph, argv[2]);
+
+    if(!verify_binary_instance(argv[2])) {
+        std::cerr << "Verification of " << argv[2] << " failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << graph.num_nodes() << " nodes, " << graph.matrix_bytes() << " bytes of ";
+    std::cout << (graph.distance_type() == DistanceType::UInt16 ? "16-bit integer" : "float") << " distances, ";
+    std::cout << (graph.matrix_layout() == MatrixLayout::PackedSymmetric ? "packed symmetric" : "full") << " layout." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include "../../src/DefaultRandomVectorGenerator.h"
+#include "../../src/DefaultSolverVisitor.h"
+#include "../../src/ProcessIslandSolver.h"
+#include "../../src/ParamsBuilder.h"
+
+#include "Graph.h"
+#include "RandomVectorEvaluator.h"
+
+/**
+ * Runs one island of a multi-process island model on a TSP instance.
+ * Usage: distributed <instance> <own index> <endpoint 0> <endpoint 1> ...
+ * Each process must be given the same list of endpoints; see run_distributed.sh.
+ */
+int main(int argc, char* argv[]) {
+    using namespace bga;
+    using namespace bga::tsp;
+
+    if(argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <instance> <own index> <endpoint 0> <endpoint 1> ..." << std::endl;
+        return 1;
+    }
+
+    const auto instance = std::string(argv[1]);
+    const auto own_index = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+    const auto endpoints = std::vector<std::string>(argv + 3, argv + argc);
+
+    auto graph = Graph{instance};
+    auto generator = DefaultRandomVectorGenerator{graph.num_nodes()};
+    auto evaluator = RandomVectorEvaluator{graph};
+    auto visitor = DefaultSolverVisitor<RandomVectorIndividual>{instance + "-results-rk-" + std::to_string(own_index) + ".csv"};
+    auto params = ParamsBuilder{}.with_timeout_s(60).with_visitor_freq_iterations(1).with_migration_freq_generations(50).build();
+    auto solver = ProcessIslandSolver<DefaultRandomVectorGenerator, RandomVectorEvaluator>{
+        params, generator, evaluator, visitor, endpoints, own_index
+    };
+
+    solver.solve();
+
+    return 0;
+}
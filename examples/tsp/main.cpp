@@ -1,11 +1,11 @@
 #include <iostream>
 
-#include "../../DefaultTranspositionVectorGenerator.h"
+#include "../../src/DefaultTranspositionVectorGenerator.h"
 #include "../../src/DefaultRandomVectorGenerator.h"
-#include "../../TranspositionVectorIndividual.h"
-#include "../../DefaultSolverVisitor.h"
-#include "../../ParamsBuilder.h"
-#include "../../Solver.h"
+#include "../../src/TranspositionVectorIndividual.h"
+#include "../../src/DefaultSolverVisitor.h"
+#include "../../src/ParamsBuilder.h"
+#include "../../src/Solver.h"
 
 #include "Graph.h"
 #include "RandomVectorEvaluator.h"
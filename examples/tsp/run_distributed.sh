@@ -0,0 +1,36 @@
+#!/bin/sh
+# Spawns several local processes of the distributed example, which exchange
+# their elite individuals over Unix domain sockets.
+# Usage: run_distributed.sh <distributed executable> <instance> [number of processes]
+
+set -e
+
+executable=$1
+instance=$2
+nprocs=${3:-4}
+
+socket_dir=$(mktemp -d)
+trap 'rm -rf "$socket_dir"' EXIT
+
+endpoints=""
+for i in $(seq 0 $((nprocs - 1))); do
+    endpoints="$endpoints unix:$socket_dir/island-$i.sock"
+done
+
+pids=""
+for i in $(seq 0 $((nprocs - 1))); do
+    "$executable" "$instance" "$i" $endpoints > "$socket_dir/island-$i.log" 2>&1 &
+    pids="$pids $!"
+done
+
+status=0
+for pid in $pids; do
+    wait "$pid" || status=1
+done
+
+for i in $(seq 0 $((nprocs - 1))); do
+    echo "Process $i:"
+    cat "$socket_dir/island-$i.log"
+done
+
+exit $status
@@ -0,0 +1,356 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_CHECKPOINT_H
+#define RKBGA_CHECKPOINT_H
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Population.h"
+#include "WireFormat.h"
+#include "IndividualWithObjValue.h"
+
+namespace bga {
+    /**
+     * Checkpoints hold everything the \class Solver needs to resume a run without evaluating any
+     * individual again. A checkpoint file is a 64-byte header followed by the population, as a
+     * sequence of \file WireFormat.h frames, in the order of the population's slots (the ranking
+     * only depends on it, see \fn Population::rank):
+     *
+     *  offset  size    content
+     *  0       8       \var checkpoint_magic
+     *  8       4       format version (\var checkpoint_version)
+     *  12      4       individual type tag (see \class WireCodec)
+     *  16      8       seed (Params::seed)
+     *  24      8       number of generations evolved, which identifies the random streams of the next one
+     *  32      4       number of iterations of the main loop
+     *  36      4       number of iterations without improvement
+     *  40      4       elapsed time, in seconds
+     *  44      4       number of individuals
+     *  48      8       size of the population frames, in bytes
+     *  56      8       checksum of the population frames (see \fn checkpoint_checksum)
+     *
+     * Numbers are written in the host's byte order.
+     */
+    constexpr char checkpoint_magic[8] = {'R', 'K', 'B', 'G', 'A', 'C', 'K', 'P'};
+    constexpr uint32_t checkpoint_version = 1u;
+    constexpr uint32_t checkpoint_header_size = 64u;
+
+    /**
+     * The progress of a run, besides its population.
+     */
+    struct CheckpointState {
+        uint64_t seed;
+        uint64_t generation_count;
+        uint32_t generation;
+        uint32_t generations_no_improvement;
+        float elapsed_time_s;
+    };
+
+    /**
+     * A checkpoint read from file.
+     */
+    template<class Individual>
+    struct Checkpoint {
+        CheckpointState state;
+
+        /**
+         * The population, in the order of its slots.
+         */
+        std::vector<IndividualWithObjValue<Individual>> population;
+    };
+
+    namespace traits {
+        /**
+         * \class WireCodec is specialised for Individual, which can therefore be checkpointed.
+         */
+        template<class Individual, class = void>
+        struct has_wire_codec : std::false_type {};
+
+        template<class Individual>
+        struct has_wire_codec<Individual, std::void_t<decltype(WireCodec<Individual>::type_tag)>> : std::true_type {};
+    }
+
+    /**
+     * FNV-1a hash of a sequence of bytes.
+     */
+    inline uint64_t checkpoint_checksum(const uint8_t* data, std::size_t size) {
+        auto h = 0xCBF29CE484222325ull;
+        for(auto i = std::size_t{0}; i < size; i++) {
+            h ^= data[i];
+            h *= 0x100000001B3ull;
+        }
+        return h;
+    }
+
+    /**
+     * Serialises a population into a checkpoint.
+     * @param state         The progress of the run.
+     * @param population    The population.
+     * @param out           The buffer where the checkpoint is written; its contents are replaced.
+     */
+    template<class Individual>
+    void serialise_checkpoint(const CheckpointState& state, const Population<Individual>& population, std::vector<uint8_t>& out) {
+        out.assign(checkpoint_header_size, 0u);
+
+        for(auto k = 0u; k < population.size(); k++) {
+            serialise(population.individual(k), population.objvalue(k), out);
+        }
+
+        const auto payload_size = static_cast<uint64_t>(out.size() - checkpoint_header_size);
+
+        std::memcpy(out.data(), checkpoint_magic, sizeof(checkpoint_magic));
+        wire::store<uint32_t>(out.data() + 8, checkpoint_version);
+        wire::store<uint32_t>(out.data() + 12, WireCodec<Individual>::type_tag);
+        wire::store<uint64_t>(out.data() + 16, state.seed);
+        wire::store<uint64_t>(out.data() + 24, state.generation_count);
+        wire::store<uint32_t>(out.data() + 32, state.generation);
+        wire::store<uint32_t>(out.data() + 36, state.generations_no_improvement);
+        wire::store<float>(out.data() + 40, state.elapsed_time_s);
+        wire::store<uint32_t>(out.data() + 44, population.size());
+        wire::store<uint64_t>(out.data() + 48, payload_size);
+        wire::store<uint64_t>(out.data() + 56, checkpoint_checksum(out.data() + checkpoint_header_size, payload_size));
+    }
+
+    /**
+     * Reads a checkpoint file.
+     * @return  The checkpoint, or nothing if the file cannot be read, or is corrupted, or was
+     *          written with another format version, or for another type of individual.
+     */
+    template<class Individual>
+    std::optional<Checkpoint<Individual>> read_checkpoint(const std::string& filename) {
+        auto in = std::ifstream{filename, std::ios::in | std::ios::binary};
+        if(!in) { return std::nullopt; }
+
+        const auto bytes = std::vector<uint8_t>(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+        const auto data = bytes.data();
+
+        if(bytes.size() < checkpoint_header_size || std::memcmp(data, checkpoint_magic, sizeof(checkpoint_magic)) != 0) { return std::nullopt; }
+        if(wire::load<uint32_t>(data + 8) != checkpoint_version || wire::load<uint32_t>(data + 12) != WireCodec<Individual>::type_tag) { return std::nullopt; }
+
+        const auto payload_size = wire::load<uint64_t>(data + 48);
+        if(payload_size != bytes.size() - checkpoint_header_size) { return std::nullopt; }
+        if(wire::load<uint64_t>(data + 56) != checkpoint_checksum(data + checkpoint_header_size, payload_size)) { return std::nullopt; }
+
+        auto checkpoint = Checkpoint<Individual>{};
+        checkpoint.state.seed = wire::load<uint64_t>(data + 16);
+        checkpoint.state.generation_count = wire::load<uint64_t>(data + 24);
+        checkpoint.state.generation = wire::load<uint32_t>(data + 32);
+        checkpoint.state.generations_no_improvement = wire::load<uint32_t>(data + 36);
+        checkpoint.state.elapsed_time_s = wire::load<float>(data + 40);
+
+        const auto size = wire::load<uint32_t>(data + 44);
+        if(size > payload_size / wire_header_size) { return std::nullopt; }
+        checkpoint.population.reserve(size);
+
+        auto offset = std::size_t{checkpoint_header_size};
+        for(auto k = 0u; k < size; k++) {
+            const auto frame = frame_size(data + offset, bytes.size() - offset);
+            if(frame == 0u || frame > bytes.size() - offset) { return std::nullopt; }
+
+            auto record = deserialise<Individual>(data + offset, frame);
+            if(!record) { return std::nullopt; }
+
+            checkpoint.population.push_back(std::move(*record));
+            offset += frame;
+        }
+
+        if(offset != bytes.size()) { return std::nullopt; }
+
+        return checkpoint;
+    }
+
+    /**
+     * Flushes a directory to disk, so that the renames in it survive a crash.
+     * @return  Whether the directory was flushed.
+     */
+    inline bool sync_directory(const std::string& directory) {
+        const auto fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if(fd < 0) { return false; }
+
+        const auto synced = (::fsync(fd) == 0);
+        return (::close(fd) == 0) && synced;
+    }
+
+    /**
+     * Replaces the contents of a file in a crash-safe way: the bytes are written to a temporary
+     * file in the same directory, flushed to disk, and the temporary file is then renamed over the
+     * old one, so that the file always holds either the old or the new contents. The directory is
+     * then flushed too, so that the new contents survive a crash.
+     * @return  Whether the file was written.
+     */
+    inline bool write_file_atomically(const std::string& filename, const std::vector<uint8_t>& bytes) {
+        const auto temporary = filename + ".tmp";
+
+        const auto fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0) { return false; }
+
+        auto written = std::size_t{0};
+        while(written < bytes.size()) {
+            const auto n = ::write(fd, bytes.data() + written, bytes.size() - written);
+            if(n <= 0) { break; }
+            written += static_cast<std::size_t>(n);
+        }
+
+        const auto synced = (written == bytes.size()) && (::fsync(fd) == 0);
+
+        if(::close(fd) != 0 || !synced) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        if(std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        const auto separator = filename.find_last_of('/');
+        const auto directory = (separator == std::string::npos) ? std::string{"."} : filename.substr(0u, std::max<std::size_t>(separator, 1u));
+
+        return sync_directory(directory);
+    }
+
+    /**
+     * Writes checkpoints to a file from a background thread, so that the solver only pays for
+     * serialising the population. If a checkpoint is submitted while the previous one is still
+     * being written, it replaces any other checkpoint waiting to be written: only the most recent
+     * one matters.
+     */
+    class CheckpointWriter {
+        /**
+         * The checkpoint file.
+         */
+        const std::string filename;
+
+        /**
+         * The checkpoint waiting to be written, if any.
+         */
+        std::vector<uint8_t> pending;
+
+        /**
+         * Whether \member pending holds a checkpoint.
+         */
+        bool has_pending;
+
+        /**
+         * Whether the background thread is writing a checkpoint.
+         */
+        bool writing;
+
+        /**
+         * Set when the writer is being destroyed.
+         */
+        bool stopping;
+
+        /**
+         * Number of checkpoints which could not be written.
+         */
+        std::atomic<uint64_t> failures;
+
+        /**
+         * Protects the members above (but \member failures), and signals their changes.
+         */
+        std::mutex mtx;
+        std::condition_variable changed;
+
+        /**
+         * The background thread.
+         */
+        std::thread writer;
+
+        /**
+         * Main loop of the background thread.
+         */
+        void work() {
+            auto bytes = std::vector<uint8_t>();
+
+            while(true) {
+                {
+                    std::unique_lock<std::mutex> lock{mtx};
+                    changed.wait(lock, [this] () { return has_pending || stopping; });
+                    if(!has_pending) { return; }
+
+                    std::swap(bytes, pending);
+                    has_pending = false;
+                    writing = true;
+                }
+
+                if(!write_file_atomically(filename, bytes)) { failures.fetch_add(1u, std::memory_order_relaxed); }
+
+                {
+                    std::lock_guard<std::mutex> lock{mtx};
+                    writing = false;
+                }
+                changed.notify_all();
+            }
+        }
+
+    public:
+        /**
+         * Starts the background thread.
+         * @param filename  The checkpoint file.
+         */
+        explicit CheckpointWriter(std::string filename) :
+            filename{std::move(filename)}, has_pending{false}, writing{false}, stopping{false}, failures{0u},
+            writer{[this] () { work(); }} {}
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        /**
+         * Writes the last checkpoint submitted, if any, and stops the background thread.
+         */
+        ~CheckpointWriter() {
+            {
+                std::lock_guard<std::mutex> lock{mtx};
+                stopping = true;
+            }
+            changed.notify_all();
+            writer.join();
+        }
+
+        /**
+         * Queues a checkpoint for writing.
+         * @param bytes The checkpoint (see \fn serialise_checkpoint). It is exchanged with the buffer
+         *              of an older checkpoint, which can be reused.
+         */
+        void submit(std::vector<uint8_t>& bytes) {
+            {
+                std::lock_guard<std::mutex> lock{mtx};
+                std::swap(pending, bytes);
+                has_pending = true;
+            }
+            changed.notify_all();
+        }
+
+        /**
+         * Waits until all the submitted checkpoints are written.
+         */
+        void wait() {
+            std::unique_lock<std::mutex> lock{mtx};
+            changed.wait(lock, [this] () { return !has_pending && !writing; });
+        }
+
+        /**
+         * Number of checkpoints which could not be written.
+         */
+        uint64_t failed_writes() const { return failures.load(std::memory_order_relaxed); }
+    };
+}
+
+#endif //RKBGA_CHECKPOINT_H
@@ -0,0 +1,226 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_CONCURRENTPOPULATION_H
+#define RKBGA_CONCURRENTPOPULATION_H
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <shared_mutex>
+#include "IndividualWithObjValue.h"
+
+namespace bga {
+    /**
+     * Fixed-size population which many threads can read and update at the same time. It is split
+     * in three tiers:
+     *  - the elite, i.e. the best individuals outside of the mutant tier;
+     *  - the non-elite, i.e. the other individuals outside of the mutant tier;
+     *  - the mutant tier, i.e. the most recent mutants, whatever their objective value.
+     * A new offspring evicts the worst non-elite individual, if it is better (see \fn insert). A new
+     * mutant evicts the oldest one, which then competes with the non-elite individuals as an offspring
+     * would (see \fn insert_mutant), so that each mutant can be bred for a while, as in the
+     * generational algorithm. Elite and non-elite individuals are kept in two max-heaps of slots, by
+     * objective value, so that an insertion only moves O(log(size)) indices, not chromosomes, and
+     * parents are picked by their position in a heap, without needing a full ranking.
+     * Readers share a lock, and are only excluded while an insertion moves the indices; offspring
+     * which are not better than the worst non-elite individual are rejected without any lock.
+     * @tparam Individual   The individual used in the Genetic Algorithm.
+     */
+    template<class Individual>
+    class ConcurrentPopulation {
+        /**
+         * The individuals.
+         */
+        std::vector<Individual> individuals;
+
+        /**
+         * Objective value of each individual.
+         */
+        std::vector<float> objvalues;
+
+        /**
+         * Slots of the elite and non-elite individuals, as max-heaps by objective value: the first
+         * entry of each is its worst individual. No elite individual is worse than a non-elite one.
+         */
+        std::vector<uint32_t> elite;
+        std::vector<uint32_t> non_elite;
+
+        /**
+         * Slots of the mutant tier, and position in it of the oldest mutant.
+         */
+        std::vector<uint32_t> mutants;
+        uint32_t oldest_mutant;
+
+        /**
+         * Slot of the best individual outside of the mutant tier.
+         */
+        uint32_t best_slot;
+
+        /**
+         * Objective value of the worst non-elite individual, read without locking.
+         */
+        std::atomic<float> worst;
+
+        /**
+         * Shared by readers, and owned by writers.
+         */
+        mutable std::shared_mutex mtx;
+
+    public:
+        ConcurrentPopulation() : oldest_mutant{0u}, best_slot{0u}, worst{0.0f} {}
+
+        /**
+         * Creates the population from individuals which have already been evaluated: the worst
+         * ones form the mutant tier, the best ones the elite. It must not be used concurrently
+         * with other methods.
+         * @param individuals   The individuals.
+         * @param objvalues     Their objective values.
+         * @param elite_size    Number of elite individuals; it must be positive.
+         * @param mutants_size  Number of individuals in the mutant tier; at least one individual
+         *                      must be left for the non-elite.
+         */
+        void assign(std::vector<Individual> individuals, std::vector<float> objvalues, uint32_t elite_size, uint32_t mutants_size) {
+            assert(individuals.size() == objvalues.size());
+            assert(elite_size > 0u && elite_size + mutants_size < individuals.size());
+
+            this->individuals = std::move(individuals);
+            this->objvalues = std::move(objvalues);
+
+            auto ranking = std::vector<uint32_t>(this->individuals.size());
+            std::iota(ranking.begin(), ranking.end(), 0u);
+            std::stable_sort(ranking.begin(), ranking.end(), [this] (uint32_t i, uint32_t j) { return this->objvalues[i] < this->objvalues[j]; });
+
+            const auto non_elite_end = ranking.end() - mutants_size;
+            elite.assign(ranking.begin(), ranking.begin() + elite_size);
+            non_elite.assign(ranking.begin() + elite_size, non_elite_end);
+            mutants.assign(non_elite_end, ranking.end());
+            oldest_mutant = 0u;
+
+            std::make_heap(elite.begin(), elite.end(), by_objvalue());
+            std::make_heap(non_elite.begin(), non_elite.end(), by_objvalue());
+
+            best_slot = ranking.front();
+            worst.store(this->objvalues[non_elite.front()]);
+        }
+
+        /**
+         * Number of elite individuals.
+         */
+        uint32_t elite_size() const { return static_cast<uint32_t>(elite.size()); }
+
+        /**
+         * Number of individuals which are not elite, including the mutant tier.
+         */
+        uint32_t non_elite_size() const { return static_cast<uint32_t>(non_elite.size() + mutants.size()); }
+
+        /**
+         * Calls fn on an elite individual and on a non-elite one (possibly a mutant), while holding
+         * a shared lock, so that they cannot be replaced in the meantime (e.g. to breed them).
+         * @param e     Index of the elite individual, in [0, \fn elite_size).
+         * @param n     Index of the non-elite individual, in [0, \fn non_elite_size).
+         */
+        template<class Fn>
+        void read_parents(uint32_t e, uint32_t n, const Fn& fn) const {
+            std::shared_lock<std::shared_mutex> lock{mtx};
+            const auto other = (n < non_elite.size()) ? non_elite[n] : mutants[n - non_elite.size()];
+            fn(individuals[elite[e]], individuals[other]);
+        }
+
+        /**
+         * Returns a copy of the best individual, with its objective value.
+         */
+        IndividualWithObjValue<Individual> best() const {
+            std::shared_lock<std::shared_mutex> lock{mtx};
+
+            auto slot = best_slot;
+            for(const auto mutant : mutants) { if(objvalues[mutant] < objvalues[slot]) { slot = mutant; } }
+
+            return IndividualWithObjValue<Individual>(individuals[slot], objvalues[slot]);
+        }
+
+        /**
+         * Inserts an offspring in place of the worst non-elite individual, if it is strictly better.
+         * @param individual    The new individual. If it enters the population, it is exchanged with
+         *                      the evicted one, whose storage can therefore be reused by the caller.
+         * @param objvalue      Its objective value.
+         * @return              Whether the new individual entered the population.
+         */
+        bool insert(Individual& individual, float objvalue) {
+            if(!(objvalue < worst.load(std::memory_order_relaxed))) { return false; }
+
+            std::unique_lock<std::shared_mutex> lock{mtx};
+            return replace_worst(individual, objvalue);
+        }
+
+        /**
+         * Inserts a mutant in place of the oldest one, which is then inserted as an offspring (see
+         * \fn insert). Without a mutant tier, the mutant itself is inserted as an offspring.
+         * @param individual    The new mutant. It is exchanged with the evicted individual, if any,
+         *                      whose storage can therefore be reused by the caller.
+         * @param objvalue      Its objective value.
+         */
+        void insert_mutant(Individual& individual, float objvalue) {
+            if(mutants.empty()) { insert(individual, objvalue); return; }
+
+            std::unique_lock<std::shared_mutex> lock{mtx};
+
+            const auto slot = mutants[oldest_mutant];
+            oldest_mutant = (oldest_mutant + 1u) % static_cast<uint32_t>(mutants.size());
+
+            using std::swap;
+            swap(individuals[slot], individual);
+            swap(objvalues[slot], objvalue);
+
+            // Now individual and objvalue are the old mutant's.
+            if(objvalue < worst.load(std::memory_order_relaxed)) { replace_worst(individual, objvalue); }
+        }
+
+    private:
+        /**
+         * Comparator making a max-heap of slots by objective value.
+         */
+        auto by_objvalue() const {
+            return [this] (uint32_t i, uint32_t j) { return objvalues[i] < objvalues[j]; };
+        }
+
+        /**
+         * Body of \fn insert, called with the exclusive lock held.
+         */
+        bool replace_worst(Individual& individual, float objvalue) {
+            const auto slot = non_elite.front();
+            if(!(objvalue < objvalues[slot])) { return false; }
+
+            using std::swap;
+            swap(individuals[slot], individual);
+            objvalues[slot] = objvalue;
+
+            // Take the slot out of the non-elite; if it beats the worst elite individual, the latter
+            // is demoted in its place.
+            std::pop_heap(non_elite.begin(), non_elite.end(), by_objvalue());
+
+            if(objvalue < objvalues[elite.front()]) {
+                std::pop_heap(elite.begin(), elite.end(), by_objvalue());
+                std::swap(elite.back(), non_elite.back());
+                std::push_heap(elite.begin(), elite.end(), by_objvalue());
+            } else {
+                non_elite.back() = slot;
+            }
+
+            std::push_heap(non_elite.begin(), non_elite.end(), by_objvalue());
+
+            if(objvalue < objvalues[best_slot]) { best_slot = slot; }
+            worst.store(objvalues[non_elite.front()], std::memory_order_relaxed);
+
+            return true;
+        }
+    };
+}
+
+#endif //RKBGA_CONCURRENTPOPULATION_H
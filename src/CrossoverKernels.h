@@ -0,0 +1,374 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_CROSSOVERKERNELS_H
+#define RKBGA_CROSSOVERKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#ifndef RKBGA_X86_KERNELS
+#define RKBGA_X86_KERNELS
+#endif
+#include <immintrin.h>
+#endif
+
+namespace bga {
+    /**
+     * Vectorised kernels for biased crossover.
+     * Instead of drawing a random number per gene from a sequential generator, the coin toss for
+     * the i-th gene is a counter-based hash of i, keyed by 64 bits drawn once from the caller's
+     * generator: the tosses of all genes are independent of each other, so they can be computed
+     * several at a time in SIMD registers, and turned into masks which select each gene from one
+     * of the parents. The kernel is chosen at runtime, according to the instruction sets supported
+     * by the CPU (AVX-512, AVX2, SSE4.1, or plain scalar code); all kernels give the same children.
+     */
+    namespace crossover {
+        /**
+         * Number of consecutive genes which are inherited together from the same parent.
+         */
+        enum class Granularity { Gene, Pair };
+
+        /**
+         * Parameters of the coin tosses of one crossover.
+         */
+        struct Tosses {
+            uint32_t key0;
+            uint32_t key1;
+
+            /**
+             * A gene is inherited from the first parent iff its hash is below the threshold.
+             */
+            uint32_t threshold;
+
+            /**
+             * Genes are grouped by shifting their index right by this amount.
+             */
+            uint32_t shift;
+        };
+
+        /**
+         * Counter-based hash of a gene index: two rounds of a 32-bit integer finaliser
+         * (Wellons' "lowbias32"), keyed by the two halves of the key.
+         */
+        inline uint32_t toss(uint32_t index, const Tosses& tosses) {
+            auto h = index ^ tosses.key0;
+            h = (h ^ (h >> 16u)) * 0x7FEB352Du;
+            h = (h ^ (h >> 15u)) * 0x846CA68Bu;
+            h = (h ^ (h >> 16u)) ^ tosses.key1;
+            h = (h ^ (h >> 16u)) * 0x7FEB352Du;
+            h = (h ^ (h >> 15u)) * 0x846CA68Bu;
+            return h ^ (h >> 16u);
+        }
+
+        /**
+         * Signature of the vectorised kernels: they blend the genes (of 16 or 32 bits, depending on
+         * the kernel) in positions [0, size) of two parents, and return the number of genes processed (a multiple of their width);
+         * the remaining ones are left to the scalar code.
+         */
+        using Kernel = uint32_t (*)(const void*, const void*, void*, uint32_t, const Tosses&);
+
+#ifdef RKBGA_X86_KERNELS
+        __attribute__((target("sse4.1")))
+        inline __m128i toss_sse(__m128i index, __m128i key0, __m128i key1) {
+            auto h = _mm_xor_si128(index, key0);
+            h = _mm_mullo_epi32(_mm_xor_si128(h, _mm_srli_epi32(h, 16)), _mm_set1_epi32(0x7FEB352D));
+            h = _mm_mullo_epi32(_mm_xor_si128(h, _mm_srli_epi32(h, 15)), _mm_set1_epi32(static_cast<int>(0x846CA68Bu)));
+            h = _mm_xor_si128(_mm_xor_si128(h, _mm_srli_epi32(h, 16)), key1);
+            h = _mm_mullo_epi32(_mm_xor_si128(h, _mm_srli_epi32(h, 16)), _mm_set1_epi32(0x7FEB352D));
+            h = _mm_mullo_epi32(_mm_xor_si128(h, _mm_srli_epi32(h, 15)), _mm_set1_epi32(static_cast<int>(0x846CA68Bu)));
+            return _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t blend_sse(const void* first, const void* second, void* child, uint32_t size, const Tosses& tosses) {
+            const auto key0 = _mm_set1_epi32(static_cast<int>(tosses.key0));
+            const auto key1 = _mm_set1_epi32(static_cast<int>(tosses.key1));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(tosses.shift));
+
+            // Unsigned comparison, via signed comparison of the values with flipped sign bits.
+            const auto sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+            const auto threshold = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(tosses.threshold)), sign);
+
+            auto index = _mm_setr_epi32(0, 1, 2, 3);
+            auto i = 0u;
+
+            for(; i + 4u <= size; i += 4u, index = _mm_add_epi32(index, _mm_set1_epi32(4))) {
+                const auto h = toss_sse(_mm_srl_epi32(index, shift), key0, key1);
+                const auto mask = _mm_cmpgt_epi32(threshold, _mm_xor_si128(h, sign));
+                const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(static_cast<const uint32_t*>(first) + i));
+                const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(static_cast<const uint32_t*>(second) + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<uint32_t*>(child) + i), _mm_blendv_epi8(b, a, mask));
+            }
+
+            return i;
+        }
+
+        __attribute__((target("sse4.1")))
+        inline uint32_t blend16_sse(const void* first, const void* second, void* child, uint32_t size, const Tosses& tosses) {
+            const auto key0 = _mm_set1_epi32(static_cast<int>(tosses.key0));
+            const auto key1 = _mm_set1_epi32(static_cast<int>(tosses.key1));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(tosses.shift));
+            const auto sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+            const auto threshold = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(tosses.threshold)), sign);
+
+            auto index = _mm_setr_epi32(0, 1, 2, 3);
+            auto i = 0u;
+
+            for(; i + 8u <= size; i += 8u, index = _mm_add_epi32(index, _mm_set1_epi32(8))) {
+                const auto low = toss_sse(_mm_srl_epi32(index, shift), key0, key1);
+                const auto high = toss_sse(_mm_srl_epi32(_mm_add_epi32(index, _mm_set1_epi32(4)), shift), key0, key1);
+
+                // Narrow the 32-bit masks of the eight genes to 16 bits.
+                const auto mask = _mm_packs_epi32(_mm_cmpgt_epi32(threshold, _mm_xor_si128(low, sign)),
+                                                  _mm_cmpgt_epi32(threshold, _mm_xor_si128(high, sign)));
+                const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(static_cast<const uint16_t*>(first) + i));
+                const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(static_cast<const uint16_t*>(second) + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<uint16_t*>(child) + i), _mm_blendv_epi8(b, a, mask));
+            }
+
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i toss_avx2(__m256i index, __m256i key0, __m256i key1) {
+            auto h = _mm256_xor_si256(index, key0);
+            h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 16)), _mm256_set1_epi32(0x7FEB352D));
+            h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 15)), _mm256_set1_epi32(static_cast<int>(0x846CA68Bu)));
+            h = _mm256_xor_si256(_mm256_xor_si256(h, _mm256_srli_epi32(h, 16)), key1);
+            h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 16)), _mm256_set1_epi32(0x7FEB352D));
+            h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 15)), _mm256_set1_epi32(static_cast<int>(0x846CA68Bu)));
+            return _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t blend_avx2(const void* first, const void* second, void* child, uint32_t size, const Tosses& tosses) {
+            const auto key0 = _mm256_set1_epi32(static_cast<int>(tosses.key0));
+            const auto key1 = _mm256_set1_epi32(static_cast<int>(tosses.key1));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(tosses.shift));
+
+            // Unsigned comparison, via signed comparison of the values with flipped sign bits.
+            const auto sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+            const auto threshold = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(tosses.threshold)), sign);
+
+            auto index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            auto i = 0u;
+
+            for(; i + 8u <= size; i += 8u, index = _mm256_add_epi32(index, _mm256_set1_epi32(8))) {
+                const auto h = toss_avx2(_mm256_srl_epi32(index, shift), key0, key1);
+                const auto mask = _mm256_cmpgt_epi32(threshold, _mm256_xor_si256(h, sign));
+                const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(static_cast<const uint32_t*>(first) + i));
+                const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(static_cast<const uint32_t*>(second) + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(static_cast<uint32_t*>(child) + i), _mm256_blendv_epi8(b, a, mask));
+            }
+
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        inline uint32_t blend16_avx2(const void* first, const void* second, void* child, uint32_t size, const Tosses& tosses) {
+            const auto key0 = _mm256_set1_epi32(static_cast<int>(tosses.key0));
+            const auto key1 = _mm256_set1_epi32(static_cast<int>(tosses.key1));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(tosses.shift));
+            const auto sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+            const auto threshold = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(tosses.threshold)), sign);
+
+            auto index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            auto i = 0u;
+
+            for(; i + 16u <= size; i += 16u, index = _mm256_add_epi32(index, _mm256_set1_epi32(16))) {
+                const auto low = toss_avx2(_mm256_srl_epi32(index, shift), key0, key1);
+                const auto high = toss_avx2(_mm256_srl_epi32(_mm256_add_epi32(index, _mm256_set1_epi32(8)), shift), key0, key1);
+
+                // Narrow the 32-bit masks of the sixteen genes to 16 bits; packing works within
+                // 128-bit lanes, so the middle quarters must be swapped back into gene order.
+                const auto packed = _mm256_packs_epi32(_mm256_cmpgt_epi32(threshold, _mm256_xor_si256(low, sign)),
+                                                       _mm256_cmpgt_epi32(threshold, _mm256_xor_si256(high, sign)));
+                const auto mask = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+                const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(static_cast<const uint16_t*>(first) + i));
+                const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(static_cast<const uint16_t*>(second) + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(static_cast<uint16_t*>(child) + i), _mm256_blendv_epi8(b, a, mask));
+            }
+
+            return i;
+        }
+
+        // GCC warns about the undefined pass-through operand of AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+        __attribute__((target("avx512f")))
+        inline __m512i toss_avx512(__m512i index, __m512i key0, __m512i key1) {
+            auto h = _mm512_xor_si512(index, key0);
+            h = _mm512_mullo_epi32(_mm512_xor_si512(h, _mm512_srli_epi32(h, 16)), _mm512_set1_epi32(0x7FEB352D));
+            h = _mm512_mullo_epi32(_mm512_xor_si512(h, _mm512_srli_epi32(h, 15)), _mm512_set1_epi32(static_cast<int>(0x846CA68Bu)));
+            h = _mm512_xor_si512(_mm512_xor_si512(h, _mm512_srli_epi32(h, 16)), key1);
+            h = _mm512_mullo_epi32(_mm512_xor_si512(h, _mm512_srli_epi32(h, 16)), _mm512_set1_epi32(0x7FEB352D));
+            h = _mm512_mullo_epi32(_mm512_xor_si512(h, _mm512_srli_epi32(h, 15)), _mm512_set1_epi32(static_cast<int>(0x846CA68Bu)));
+            return _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+        }
+
+        __attribute__((target("avx512f")))
+        inline uint32_t blend_avx512(const void* first, const void* second, void* child, uint32_t size, const Tosses& tosses) {
+            const auto key0 = _mm512_set1_epi32(static_cast<int>(tosses.key0));
+            const auto key1 = _mm512_set1_epi32(static_cast<int>(tosses.key1));
+            const auto threshold = _mm512_set1_epi32(static_cast<int>(tosses.threshold));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(tosses.shift));
+
+            auto index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            auto i = 0u;
+
+            for(; i + 16u <= size; i += 16u, index = _mm512_add_epi32(index, _mm512_set1_epi32(16))) {
+                const auto h = toss_avx512(_mm512_srl_epi32(index, shift), key0, key1);
+                const auto mask = _mm512_cmplt_epu32_mask(h, threshold);
+                const auto a = _mm512_loadu_si512(static_cast<const uint32_t*>(first) + i);
+                const auto b = _mm512_loadu_si512(static_cast<const uint32_t*>(second) + i);
+                _mm512_storeu_si512(static_cast<uint32_t*>(child) + i, _mm512_mask_blend_epi32(mask, b, a));
+            }
+
+            return i;
+        }
+
+        __attribute__((target("avx512f,avx512bw")))
+        inline uint32_t blend16_avx512(const void* first, const void* second, void* child, uint32_t size, const Tosses& tosses) {
+            const auto key0 = _mm512_set1_epi32(static_cast<int>(tosses.key0));
+            const auto key1 = _mm512_set1_epi32(static_cast<int>(tosses.key1));
+            const auto threshold = _mm512_set1_epi32(static_cast<int>(tosses.threshold));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(tosses.shift));
+
+            auto index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            auto i = 0u;
+
+            for(; i + 32u <= size; i += 32u, index = _mm512_add_epi32(index, _mm512_set1_epi32(32))) {
+                const auto low = toss_avx512(_mm512_srl_epi32(index, shift), key0, key1);
+                const auto high = toss_avx512(_mm512_srl_epi32(_mm512_add_epi32(index, _mm512_set1_epi32(16)), shift), key0, key1);
+                const auto mask = static_cast<__mmask32>(_mm512_cmplt_epu32_mask(low, threshold)) |
+                                  (static_cast<__mmask32>(_mm512_cmplt_epu32_mask(high, threshold)) << 16u);
+                const auto a = _mm512_loadu_si512(static_cast<const uint16_t*>(first) + i);
+                const auto b = _mm512_loadu_si512(static_cast<const uint16_t*>(second) + i);
+                _mm512_storeu_si512(static_cast<uint16_t*>(child) + i, _mm512_mask_blend_epi16(mask, b, a));
+            }
+
+            return i;
+        }
+#pragma GCC diagnostic pop
+#endif
+
+        /**
+         * Picks the widest kernel for genes of the given width (2 or 4 bytes) supported by the CPU,
+         * or nullptr if none is.
+         */
+        inline Kernel select_kernel(std::size_t gene_width) {
+#ifdef RKBGA_X86_KERNELS
+            __builtin_cpu_init();
+            if(gene_width == 4u) {
+                if(__builtin_cpu_supports("avx512f")) { return &blend_avx512; }
+                if(__builtin_cpu_supports("avx2")) { return &blend_avx2; }
+                if(__builtin_cpu_supports("sse4.1")) { return &blend_sse; }
+            } else {
+                if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) { return &blend16_avx512; }
+                if(__builtin_cpu_supports("avx2")) { return &blend16_avx2; }
+                if(__builtin_cpu_supports("sse4.1")) { return &blend16_sse; }
+            }
+#endif
+            return nullptr;
+        }
+
+        /**
+         * The kernel used on this machine for a gene type, chosen once.
+         */
+        template<class Gene>
+        inline Kernel kernel() {
+            static const auto selected = select_kernel(sizeof(Gene));
+            return selected;
+        }
+
+        /**
+         * Draws the key of the coin tosses from the caller's generator, and computes the threshold
+         * corresponding to the bias (callers copy the first parent when the bias is 1).
+         */
+        template<class Rng>
+        inline Tosses draw_tosses(float bias, Rng& rng, Granularity granularity) {
+            const auto key0 = static_cast<uint32_t>(rng());
+            const auto key1 = static_cast<uint32_t>(rng());
+            const auto threshold = (bias <= 0.0f) ? 0u : (bias >= 1.0f) ? 0xFFFFFFFFu :
+                                   static_cast<uint32_t>(static_cast<double>(bias) * 4294967296.0);
+
+            return Tosses{key0, key1, threshold, (granularity == Granularity::Pair) ? 1u : 0u};
+        }
+
+        /**
+         * Writes the child of two parents, each gene (or pair of genes) of which is inherited from
+         * the first parent with probability \param bias and from the second one otherwise.
+         * The genes must be 16 or 32-bit wide. The child may not overlap with the parents.
+         * @param first         Genes of the first parent.
+         * @param second        Genes of the second parent.
+         * @param child         Genes of the child.
+         * @param size          Number of genes; with Granularity::Pair, it must be even.
+         * @param bias          Probability of inheriting from the first parent.
+         * @param rng           Generator from which the key of the coin tosses is drawn.
+         * @param granularity   Whether genes are inherited one by one or in pairs.
+         */
+        template<class Gene, class Rng>
+        void biased_crossover(const Gene* first, const Gene* second, Gene* child, uint32_t size, float bias, Rng& rng,
+                              Granularity granularity = Granularity::Gene) {
+            static_assert((sizeof(Gene) == 2u || sizeof(Gene) == 4u) && std::is_trivially_copyable<Gene>::value,
+                          "Genes must be 16 or 32-bit wide");
+
+            const auto tosses = draw_tosses(bias, rng, granularity);
+
+            if(bias >= 1.0f) {
+                std::memcpy(child, first, size * sizeof(Gene));
+                return;
+            }
+
+            auto i = 0u;
+            if(const auto vectorised = kernel<Gene>()) { i = vectorised(first, second, child, size, tosses); }
+
+            for(; i < size; i++) {
+                child[i] = (toss(i >> tosses.shift, tosses) < tosses.threshold) ? first[i] : second[i];
+            }
+        }
+
+        /**
+         * Chromosomes shorter than this are blended by fully unrolled scalar code, rather than
+         * by the vectorised kernels, whose call through a pointer would not pay off.
+         */
+        constexpr uint32_t min_vectorised_size = 16u;
+
+        /**
+         * Same as the other overload, for chromosomes whose length is known at compile time: short
+         * ones are blended by unrolled scalar code, long ones by the vectorised kernel with a tail
+         * of known length. Both give the same child as the other overload.
+         */
+        template<uint32_t Size, class Gene, class Rng>
+        void biased_crossover(const Gene* first, const Gene* second, Gene* child, float bias, Rng& rng,
+                              Granularity granularity = Granularity::Gene) {
+            static_assert((sizeof(Gene) == 2u || sizeof(Gene) == 4u) && std::is_trivially_copyable<Gene>::value,
+                          "Genes must be 16 or 32-bit wide");
+
+            const auto tosses = draw_tosses(bias, rng, granularity);
+
+            if(bias >= 1.0f) {
+                std::memcpy(child, first, Size * sizeof(Gene));
+                return;
+            }
+
+            auto i = 0u;
+
+            if constexpr(Size >= min_vectorised_size) {
+                if(const auto vectorised = kernel<Gene>()) { i = vectorised(first, second, child, Size, tosses); }
+            }
+
+#pragma GCC unroll 16
+            for(; i < Size; i++) {
+                child[i] = (toss(i >> tosses.shift, tosses) < tosses.threshold) ? first[i] : second[i];
+            }
+        }
+    }
+}
+
+#endif //RKBGA_CROSSOVERKERNELS_H
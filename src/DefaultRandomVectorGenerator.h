@@ -5,62 +5,93 @@
 #ifndef RKBGA_DEFAULTRANDOMVECTORGENERATOR_H
 #define RKBGA_DEFAULTRANDOMVECTORGENERATOR_H
 
+#include <vector>
 #include <cstdint>
-#include <random>
-#include <algorithm>
-#include <functional>
+#include "Random.h"
+#include "Xoshiro256pp.h"
 #include "RandomVectorIndividual.h"
 
 namespace bga {
     /**
      * Simple random-vector generator, which produces a random-key individual
-     * of a given size, with random numbers in [0,1]. If the user has no particular
+     * of a given size, with random numbers in [0,1). If the user has no particular
      * requirement on the construction of the individual besides the vector's
      * length, he can use this generator. Otherwise, he will have to implement
      * his own generator.
+     * @tparam Engine   The random engine used by \fn generate when no engine is passed,
+     *                  e.g. \class Xoshiro256pp, \class Pcg64, \class Philox4x32 or std::mt19937.
      */
-    class DefaultRandomVectorGenerator {
+    template<class Engine>
+    class RandomVectorGenerator {
         /**
          * Random-key vector length.
          */
         const uint32_t length;
 
         /**
-         * Mersenne Twister used to generate the new individuals.
+         * Engine used to generate the new individuals.
          */
-        mutable std::mt19937 mt;
+        mutable Engine engine;
 
     public:
         using individual_type = RandomVectorIndividual;
 
         /**
          * New random vector generator for vectors of fixed length whose entries
-         * are random numbers in [0,1].
+         * are random numbers in [0,1). Its own engine is seeded from the system's
+         * random device.
          * @param length  The length of the generated vectors.
          */
-        DefaultRandomVectorGenerator(uint32_t length) : length{length} {
-            // Initialise the mersenne twister.
-            std::mt19937::result_type random_data[std::mt19937::state_size];
-            std::random_device source;
-            std::generate(std::begin(random_data), std::end(random_data), std::ref(source));
-            std::seed_seq seeds(std::begin(random_data), std::end(random_data));
-            std::mt19937(seeds);
+        RandomVectorGenerator(uint32_t length) : RandomVectorGenerator{length, random_seed()} {}
+
+        /**
+         * New random vector generator for vectors of fixed length whose entries
+         * are random numbers in [0,1), with a seeded engine.
+         * @param length  The length of the generated vectors.
+         * @param seed    The seed.
+         */
+        RandomVectorGenerator(uint32_t length, uint64_t seed) : length{length}, engine{make_engine<Engine>(seed, 0u)} {}
+
+        /**
+         * Generate a new random \class RandomVectorIndividual, with the generator's own engine.
+         */
+        RandomVectorIndividual generate() const { return generate(engine); }
+
+        /**
+         * Generate a new random \class RandomVectorIndividual, drawing the random numbers from a given
+         * generator. Unlike the overload without parameters, this one can be called concurrently.
+         */
+        template<class Rng>
+        RandomVectorIndividual generate(Rng& rng) const {
+          auto chromosome = std::vector<float>(length);
+
+          // Fill the chromosome with random numbers, in bulk.
+          fill_uniform_floats(rng, chromosome.data(), length);
+
+          return RandomVectorIndividual{std::move(chromosome)};
         }
 
         /**
-         * Generate a new random \class RandomVectorIndividual.
+         * Overwrites an existing individual with a new random one, reusing its storage.
          */
-        RandomVectorIndividual generate() const {
-          auto dist = std::uniform_real_distribution<float>(0, 1);
-          auto chromosome = std::vector<float>();
-          chromosome.reserve(length);
+        void generate_into(RandomVectorIndividual& individual) const { generate_into(individual, engine); }
 
-          // Fill the chromosome with random numbers.
-          for(auto i = 0u; i < length; i++) { chromosome.push_back(dist(mt)); }
+        /**
+         * Overwrites an existing individual with a new random one, reusing its storage and drawing
+         * the random numbers from a given generator. This can be called concurrently.
+         */
+        template<class Rng>
+        void generate_into(RandomVectorIndividual& individual, Rng& rng) const {
+          if(individual.size() != length) { individual = generate(rng); return; }
 
-          return RandomVectorIndividual{chromosome};
+          fill_uniform_floats(rng, individual.data(), length);
         }
     };
+
+    /**
+     * Random-vector generator with the default engine.
+     */
+    using DefaultRandomVectorGenerator = RandomVectorGenerator<Xoshiro256pp>;
 }
 
 #endif //RKBGA_RANDOMVECTORGENERATOR_H
@@ -5,9 +5,12 @@
 #ifndef RKBGA_DEFAULTSOLVERVISITOR_H
 #define RKBGA_DEFAULTSOLVERVISITOR_H
 
+#include <memory>
 #include <string>
-#include <fstream>
 #include <iostream>
+#include "FitnessCache.h"
+#include "Profiling.h"
+#include "TraceWriter.h"
 #include "IndividualWithObjValue.h"
 
 namespace bga {
@@ -15,6 +18,8 @@ namespace bga {
      * Utility class that implements a default solver for the visitor.
      * The solver is called before starting the algorithm, then after a certain
      * amount of iterations (multiple times), and finally at the end of the algorithm.
+     * The log is written by a \class TraceWriter on a background thread, so logging
+     * every iteration does not slow down the solver.
      *
      * @tparam Individual   The individual used in the Genetic Algorithm.
      */
@@ -26,34 +31,56 @@ namespace bga {
         const std::string outfile_name;
 
         /**
-         * Outfile stream.
+         * Writes the log.
          */
-        mutable std::ofstream* outfile;
+        std::unique_ptr<TraceWriter> trace;
 
-    public:
         /**
-         * Constructs a visitor that logs to file.
-         * @param outfile_name  Filename of the logs file.
+         * Last counters received from the evaluation cache.
          */
-        DefaultSolverVisitor(std::string outfile_name) : outfile_name{outfile_name}, outfile{new std::ofstream{outfile_name, std::ios::out}} {
-            *outfile << "iteration,time,bestobj" << std::endl;
-        }
+        mutable CacheStats cache_stats;
+
+        /**
+         * Sum of the stats of all generations.
+         */
+        mutable GenerationStats total_stats;
+
+        /**
+         * Sum of the stats of the generations since the last line of the log.
+         */
+        mutable GenerationStats pending_stats;
+
+        /**
+         * Time taken by the last generation.
+         */
+        mutable double last_generation_s;
 
         /**
-         * Destructs the visitor and closes the file.
+         * Logs a line and resets \member pending_stats.
          */
-        ~DefaultSolverVisitor() {
-            outfile->close();
-            delete outfile;
+        void log(const IndividualWithObjValue<Individual>& individual, uint32_t iteration, float elapsed_time_s) const {
+            trace->push(TraceRecord{iteration, elapsed_time_s, individual.objvalue, total_stats.mean_objvalue, total_stats.worst_objvalue,
+                                    0u, pending_stats.evaluations, pending_stats.cache_hits, last_generation_s});
+            pending_stats = GenerationStats{};
         }
 
+    public:
+        /**
+         * Constructs a visitor that logs to file.
+         * @param outfile_name  Filename of the logs file.
+         * @param format        Format of the logs file.
+         */
+        DefaultSolverVisitor(std::string outfile_name, TraceFormat format = TraceFormat::Csv) :
+            outfile_name{outfile_name}, trace{std::make_unique<TraceWriter>(outfile_name, format)}, cache_stats{0u, 0u},
+            total_stats{}, pending_stats{}, last_generation_s{0.0} {}
+
         /**
          * Action to be invoked before the genetic part of the algorithm starts.
          * (I.e., after the initial population creation, but before the first crossover).
          * @param individual    The best individual in the intial population.
          */
         void at_start(const IndividualWithObjValue<Individual>& individual) const {
-            *outfile << "0,0," << individual.objvalue << std::endl;
+            log(individual, 0u, 0.0f);
         }
 
         /**
@@ -63,7 +90,25 @@ namespace bga {
          * @param elapsed_time_s    Current elapsed time.
          */
         void at_iteration(const IndividualWithObjValue<Individual>& individual, uint32_t iteration, float elapsed_time_s) const {
-            *outfile << iteration << "," << elapsed_time_s << "," << individual.objvalue << std::endl;
+            log(individual, iteration, elapsed_time_s);
+        }
+
+        /**
+         * Receives the counters of the evaluation cache (only called if the cache is enabled).
+         * @param stats Cache hits and misses so far.
+         */
+        void at_cache_stats(const CacheStats& stats) const {
+            cache_stats = stats;
+        }
+
+        /**
+         * Receives the stats of a generation (not called when compiling with RKBGA_PROFILING=0).
+         * @param stats Time spent in each phase of the generation, and evaluations done.
+         */
+        void at_generation_stats(const GenerationStats& stats) const {
+            total_stats.accumulate(stats);
+            pending_stats.accumulate(stats);
+            last_generation_s = stats.total_s();
         }
 
         /**
@@ -73,8 +118,28 @@ namespace bga {
          * @param elapsed_time_s    Total elapsed time.
          */
         void at_end(const IndividualWithObjValue<Individual>& individual, uint32_t iteration, float elapsed_time_s) const {
+            log(individual, iteration, elapsed_time_s);
+            trace->close();
+
             std::cout << "Terminating after " << iteration << " iterations and " << elapsed_time_s << " seconds." << std::endl;
             std::cout << "Best objective value: " << individual.objvalue << std::endl;
+
+            if(cache_stats.hits + cache_stats.misses > 0u) {
+                std::cout << "Evaluation cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses (";
+                std::cout << 100 * cache_stats.hit_rate() << "% hit rate)." << std::endl;
+            }
+
+            if(total_stats.total_s() > 0.0) {
+                std::cout << "Time per phase (s): elite copy " << total_stats.elite_copy_s << ", mutants " << total_stats.mutants_s;
+                std::cout << ", crossover " << total_stats.crossover_s << ", evaluation " << total_stats.evaluation_s;
+                std::cout << ", ranking " << total_stats.ranking_s << ", improvement " << total_stats.improvement_s << "." << std::endl;
+                std::cout << "Evaluations: " << total_stats.evaluations << " (" << total_stats.evaluations_per_s() << " per second), latency p50 < ";
+                std::cout << total_stats.evaluation_latency.quantile_ns(0.5) << "ns, p99 < " << total_stats.evaluation_latency.quantile_ns(0.99) << "ns." << std::endl;
+            }
+
+            if(trace->dropped_records() > 0u) {
+                std::cout << "Log of " << outfile_name << ": " << trace->dropped_records() << " lines dropped because the writer fell behind." << std::endl;
+            }
         }
     };
 }
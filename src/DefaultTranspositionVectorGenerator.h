@@ -5,9 +5,10 @@
 #ifndef RKBGA_DEFAULTTRANSPOSITIONVECTORGENERATOR_H
 #define RKBGA_DEFAULTTRANSPOSITIONVECTORGENERATOR_H
 
-#include <random>
-#include <algorithm>
-#include <functional>
+#include <vector>
+#include <cstdint>
+#include "Random.h"
+#include "Xoshiro256pp.h"
 #include "TranspositionVectorIndividual.h"
 
 namespace bga {
@@ -18,17 +19,20 @@ namespace bga {
      * construction of the individual, besides on the vector's length (and
      * therefore range in which the individuals are picked at random), he can
      * use this generator. Otherwise, he will have to implement his own generator.
+     * @tparam Engine   The random engine used by \fn generate when no engine is passed,
+     *                  e.g. \class Xoshiro256pp, \class Pcg64, \class Philox4x32 or std::mt19937.
      */
-    class DefaultTranspositionVectorGenerator {
+    template<class Engine>
+    class TranspositionVectorGenerator {
         /**
          * Number of items of which we want to represent a permutation.
          */
         const uint32_t nitems;
 
         /**
-         * Mersenne Teister used to generate new individuals.
+         * Engine used to generate new individuals.
          */
-        mutable std::mt19937 mt;
+        mutable Engine engine;
 
     public:
         using individual_type = TranspositionVectorIndividual;
@@ -36,32 +40,60 @@ namespace bga {
         /**
          * New random vector generator for vectors of fixed length whose entries
          * are couples of items. The whole vector can be thought of as a permutation.
+         * Its own engine is seeded from the system's random device.
          * @param num_items   The number of items to permute. The vector contains
                               num_items pairs, and therefore 2*num_items elements.
          */
-        DefaultTranspositionVectorGenerator(uint32_t nitems) : nitems{nitems} {
-            // Initialise the mersenne twister.
-            std::mt19937::result_type random_data[std::mt19937::state_size];
-            std::random_device source;
-            std::generate(std::begin(random_data), std::end(random_data), std::ref(source));
-            std::seed_seq seeds(std::begin(random_data), std::end(random_data));
-            std::mt19937(seeds);
-        }
+        TranspositionVectorGenerator(uint32_t nitems) : TranspositionVectorGenerator{nitems, random_seed()} {}
+
+        /**
+         * New random vector generator for vectors of fixed length whose entries
+         * are couples of items, with a seeded engine.
+         * @param num_items   The number of items to permute.
+         * @param seed        The seed.
+         */
+        TranspositionVectorGenerator(uint32_t nitems, uint64_t seed) : nitems{nitems}, engine{make_engine<Engine>(seed, 0u)} {}
 
         /**
-         * Generate a new random \class TranspositionVectorIndividual.
+         * Generate a new random \class TranspositionVectorIndividual, with the generator's own engine.
          */
-        TranspositionVectorIndividual generate() const {
-          auto dist = std::uniform_int_distribution<uint32_t>(0, nitems - 1);
-          auto chromosome = std::vector<uint32_t>();
-          chromosome.reserve(2 * (nitems - 1));
+        TranspositionVectorIndividual generate() const { return generate(engine); }
+
+        /**
+         * Generate a new random \class TranspositionVectorIndividual, drawing the random numbers from
+         * a given generator. Unlike the overload without parameters, this one can be called concurrently.
+         */
+        template<class Rng>
+        TranspositionVectorIndividual generate(Rng& rng) const {
+          auto chromosome = std::vector<uint32_t>(2 * (nitems - 1));
 
           // Fill the chromosome with random numbers.
-          for(auto i = 0; i < 2 * (nitems - 1); i++) { chromosome.push_back(dist(mt)); }
+          for(auto& item : chromosome) { item = uniform_index(rng, nitems); }
 
-          return TranspositionVectorIndividual{chromosome};
+          return TranspositionVectorIndividual{std::move(chromosome)};
+        }
+
+        /**
+         * Overwrites an existing individual with a new random one, reusing its storage.
+         */
+        void generate_into(TranspositionVectorIndividual& individual) const { generate_into(individual, engine); }
+
+        /**
+         * Overwrites an existing individual with a new random one, reusing its storage and drawing
+         * the random numbers from a given generator. This can be called concurrently.
+         */
+        template<class Rng>
+        void generate_into(TranspositionVectorIndividual& individual, Rng& rng) const {
+          if(individual.size() != 2 * (nitems - 1)) { individual = generate(rng); return; }
+
+          for(auto i = 0u; i < 2 * (nitems - 1); i++) { individual.set_component(i, uniform_index(rng, nitems)); }
         }
     };
+
+    /**
+     * Transposition-vector generator with the default engine.
+     */
+    using DefaultTranspositionVectorGenerator = TranspositionVectorGenerator<Xoshiro256pp>;
 }
 
 #endif //RKBGA_DEFAULTTRANSPOSITIONVECTORGENERATOR_H
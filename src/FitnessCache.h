@@ -0,0 +1,122 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_FITNESSCACHE_H
+#define RKBGA_FITNESSCACHE_H
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace bga {
+    /**
+     * Counters reported by \class FitnessCache.
+     */
+    struct CacheStats {
+        /**
+         * Number of lookups which found the objective value in the cache.
+         */
+        uint64_t hits;
+
+        /**
+         * Number of lookups which did not, and led to an evaluation.
+         */
+        uint64_t misses;
+
+        /**
+         * Share of lookups which were hits (0 to 1).
+         */
+        float hit_rate() const { return (hits + misses == 0u) ? 0.0f : static_cast<float>(hits) / (hits + misses); }
+    };
+
+    /**
+     * Bounded cache of objective values, keyed by a 64-bit hash of an individual (or of the
+     * solution it decodes to). It is a direct-mapped table: each key has exactly one slot, and
+     * inserting a key evicts whatever was in its slot, so the cache never grows past its capacity
+     * nor allocates memory after construction. Slots are protected by striped locks, so that
+     * lookups and insertions can be done concurrently by different threads.
+     */
+    class FitnessCache {
+        /**
+         * A slot of the table.
+         */
+        struct Entry {
+            uint64_t key;
+            float objvalue;
+            bool valid;
+        };
+
+        /**
+         * The table.
+         */
+        std::vector<Entry> entries;
+
+        /**
+         * Locks; the i-th protects the slots whose index is congruent to i modulo their number.
+         */
+        std::unique_ptr<std::mutex[]> locks;
+
+        /**
+         * Number of locks (a power of two).
+         */
+        static constexpr uint32_t num_locks = 64u;
+
+        /**
+         * Counters.
+         */
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+
+        uint64_t slot_of(uint64_t key) const { return key % entries.size(); }
+        std::mutex& lock_of(uint64_t slot) const { return locks[slot & (num_locks - 1u)]; }
+
+    public:
+        /**
+         * Creates an empty cache.
+         * @param capacity  Maximum number of stored objective values.
+         */
+        explicit FitnessCache(uint32_t capacity) :
+            entries(std::max(capacity, 1u), Entry{0u, 0.0f, false}), locks{new std::mutex[num_locks]}, hits{0u}, misses{0u} {}
+
+        /**
+         * Looks up a key, and updates the hit/miss counters.
+         * @param key       The hash of the individual.
+         * @param objvalue  Output: the cached objective value, if found.
+         * @return          Whether the key was found.
+         */
+        bool lookup(uint64_t key, float& objvalue) {
+            const auto slot = slot_of(key);
+            {
+                std::lock_guard<std::mutex> lock{lock_of(slot)};
+                const auto& entry = entries[slot];
+                if(entry.valid && entry.key == key) {
+                    objvalue = entry.objvalue;
+                    ++hits;
+                    return true;
+                }
+            }
+            ++misses;
+            return false;
+        }
+
+        /**
+         * Stores the objective value of a key, evicting the previous occupant of its slot.
+         */
+        void insert(uint64_t key, float objvalue) {
+            const auto slot = slot_of(key);
+            std::lock_guard<std::mutex> lock{lock_of(slot)};
+            entries[slot] = Entry{key, objvalue, true};
+        }
+
+        /**
+         * Current value of the counters.
+         */
+        CacheStats stats() const { return CacheStats{hits.load(), misses.load()}; }
+    };
+}
+
+#endif //RKBGA_FITNESSCACHE_H
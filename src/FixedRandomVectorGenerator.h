@@ -0,0 +1,73 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_FIXEDRANDOMVECTORGENERATOR_H
+#define RKBGA_FIXEDRANDOMVECTORGENERATOR_H
+
+#include <cstdint>
+#include "Random.h"
+#include "Xoshiro256pp.h"
+#include "FixedRandomVectorIndividual.h"
+
+namespace bga {
+    /**
+     * Generator of \class FixedRandomVectorIndividual, with random keys in [0,1).
+     * It is the compile-time-length counterpart of \class RandomVectorGenerator.
+     * @tparam Size     The length of the generated chromosomes.
+     * @tparam Engine   The random engine used by \fn generate when no engine is passed.
+     */
+    template<uint32_t Size, class Engine = Xoshiro256pp>
+    class FixedRandomVectorGenerator {
+        /**
+         * Engine used to generate the new individuals.
+         */
+        mutable Engine engine;
+
+    public:
+        using individual_type = FixedRandomVectorIndividual<Size>;
+
+        /**
+         * New generator, whose own engine is seeded from the system's random device.
+         */
+        FixedRandomVectorGenerator() : FixedRandomVectorGenerator{random_seed()} {}
+
+        /**
+         * New generator, with a seeded engine.
+         * @param seed  The seed.
+         */
+        explicit FixedRandomVectorGenerator(uint64_t seed) : engine{make_engine<Engine>(seed, 0u)} {}
+
+        /**
+         * Generate a new random individual, with the generator's own engine.
+         */
+        individual_type generate() const { return generate(engine); }
+
+        /**
+         * Generate a new random individual, drawing the random numbers from a given generator.
+         * Unlike the overload without parameters, this one can be called concurrently.
+         */
+        template<class Rng>
+        individual_type generate(Rng& rng) const {
+          auto individual = individual_type{};
+          generate_into(individual, rng);
+          return individual;
+        }
+
+        /**
+         * Overwrites an existing individual with a new random one.
+         */
+        void generate_into(individual_type& individual) const { generate_into(individual, engine); }
+
+        /**
+         * Overwrites an existing individual with a new random one, drawing the random numbers
+         * from a given generator. This can be called concurrently.
+         */
+        template<class Rng>
+        void generate_into(individual_type& individual, Rng& rng) const {
+          fill_uniform_floats(rng, individual.data(), Size);
+        }
+    };
+}
+
+#endif //RKBGA_FIXEDRANDOMVECTORGENERATOR_H
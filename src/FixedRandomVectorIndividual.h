@@ -0,0 +1,101 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_FIXEDRANDOMVECTORINDIVIDUAL_H
+#define RKBGA_FIXEDRANDOMVECTORINDIVIDUAL_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include "Hash.h"
+#include "CrossoverKernels.h"
+
+namespace bga {
+    /**
+     * Random-key individual whose chromosome length is known at compile time. It behaves like
+     * \class RandomVectorIndividual, but its keys are stored inline in an aligned array, so
+     * that creating, copying and breeding individuals never allocates memory, and the crossover
+     * loop is specialised for the length.
+     * @tparam Size The length of the chromosome.
+     */
+    template<uint32_t Size>
+    class FixedRandomVectorIndividual {
+        static_assert(Size > 0u, "The chromosome cannot be empty");
+
+        /**
+         * The chromosome, made by an array of random keys.
+         */
+        alignas(64) std::array<float, Size> chromosome;
+
+    public:
+        /**
+         * Construct an individual whose keys are all zero.
+         */
+        FixedRandomVectorIndividual() : chromosome{} {}
+
+        /**
+         * Construct from an explicitely given chromosome.
+         * @param chromosome    The random-key chromosome
+         */
+        FixedRandomVectorIndividual(const std::array<float, Size>& chromosome) : chromosome{chromosome} {}
+
+        /**
+         * Produces a new individual, via biased crossover of this individual with another one.
+         * @param other The other parent individual.
+         * @param bias  Probability that the child inherits each element from this individual.
+         * @param rng   A random number generator from which the key of the biased coin tosses
+         *              is drawn (see \file CrossoverKernels.h).
+         * @return      The new child.
+         */
+        template<class Rng>
+        FixedRandomVectorIndividual biased_crossover_with(const FixedRandomVectorIndividual& other, float bias, Rng& rng) const {
+          auto child = FixedRandomVectorIndividual{};
+          biased_crossover_into(other, bias, rng, child);
+          return child;
+        }
+
+        /**
+         * Same as \fn biased_crossover_with, but writes the new individual over an existing one.
+         * @param other The other parent individual.
+         * @param bias  Probability of inheriting each element from this individual.
+         * @param rng   A random number generator used to toss the biased coin.
+         * @param child The individual which will be overwritten by the child.
+         */
+        template<class Rng>
+        void biased_crossover_into(const FixedRandomVectorIndividual& other, float bias, Rng& rng, FixedRandomVectorIndividual& child) const {
+          assert(0 <= bias && bias <= 1);
+          assert(&child != this && &child != &other);
+
+          crossover::biased_crossover<Size>(chromosome.data(), other.chromosome.data(), child.chromosome.data(), bias, rng);
+        }
+
+        /**
+         * Returns the i-th component of the chromosome.
+         */
+        float component(uint32_t i) const { return chromosome[i]; }
+
+        /**
+         * Sets the i-th component of the chromosome.
+         */
+        void set_component(uint32_t i, float value) { chromosome[i] = value; }
+
+        /**
+         * Returns a pointer to the keys of the chromosome, e.g. to overwrite them in bulk.
+         */
+        float* data() { return chromosome.data(); }
+        const float* data() const { return chromosome.data(); }
+
+        /**
+         * Returns the length of the chromosome.
+         */
+        static constexpr uint32_t size() { return Size; }
+
+        /**
+         * Returns a hash of the chromosome.
+         */
+        uint64_t hash() const { return hash_words(chromosome.data(), Size); }
+    };
+}
+
+#endif //RKBGA_FIXEDRANDOMVECTORINDIVIDUAL_H
@@ -0,0 +1,76 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_FIXEDTRANSPOSITIONVECTORGENERATOR_H
+#define RKBGA_FIXEDTRANSPOSITIONVECTORGENERATOR_H
+
+#include <cstdint>
+#include "Random.h"
+#include "Xoshiro256pp.h"
+#include "FixedTranspositionVectorIndividual.h"
+
+namespace bga {
+    /**
+     * Generator of \class FixedTranspositionVectorIndividual, made of NumItems - 1 random pairs of
+     * items in [0, NumItems-1]. It is the compile-time-length counterpart of
+     * \class TranspositionVectorGenerator.
+     * @tparam NumItems The number of items to permute.
+     * @tparam Engine   The random engine used by \fn generate when no engine is passed.
+     */
+    template<uint32_t NumItems, class Engine = Xoshiro256pp>
+    class FixedTranspositionVectorGenerator {
+        static_assert(NumItems > 1u, "At least two items are needed");
+
+        /**
+         * Engine used to generate the new individuals.
+         */
+        mutable Engine engine;
+
+    public:
+        using individual_type = FixedTranspositionVectorIndividual<2u * (NumItems - 1u)>;
+
+        /**
+         * New generator, whose own engine is seeded from the system's random device.
+         */
+        FixedTranspositionVectorGenerator() : FixedTranspositionVectorGenerator{random_seed()} {}
+
+        /**
+         * New generator, with a seeded engine.
+         * @param seed  The seed.
+         */
+        explicit FixedTranspositionVectorGenerator(uint64_t seed) : engine{make_engine<Engine>(seed, 0u)} {}
+
+        /**
+         * Generate a new random individual, with the generator's own engine.
+         */
+        individual_type generate() const { return generate(engine); }
+
+        /**
+         * Generate a new random individual, drawing the random numbers from a given generator.
+         * Unlike the overload without parameters, this one can be called concurrently.
+         */
+        template<class Rng>
+        individual_type generate(Rng& rng) const {
+          auto individual = individual_type{};
+          generate_into(individual, rng);
+          return individual;
+        }
+
+        /**
+         * Overwrites an existing individual with a new random one.
+         */
+        void generate_into(individual_type& individual) const { generate_into(individual, engine); }
+
+        /**
+         * Overwrites an existing individual with a new random one, drawing the random numbers
+         * from a given generator. This can be called concurrently.
+         */
+        template<class Rng>
+        void generate_into(individual_type& individual, Rng& rng) const {
+          for(auto i = 0u; i < individual_type::size(); i++) { individual.set_component(i, uniform_index(rng, NumItems)); }
+        }
+    };
+}
+
+#endif //RKBGA_FIXEDTRANSPOSITIONVECTORGENERATOR_H
@@ -0,0 +1,103 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_FIXEDTRANSPOSITIONVECTORINDIVIDUAL_H
+#define RKBGA_FIXEDTRANSPOSITIONVECTORINDIVIDUAL_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include "Hash.h"
+#include "CrossoverKernels.h"
+
+namespace bga {
+    /**
+     * Transposition individual whose chromosome length is known at compile time. It behaves like
+     * \class TranspositionVectorIndividual, but its pairs are stored inline in an aligned array,
+     * so that creating, copying and breeding individuals never allocates memory, and the crossover
+     * loop is specialised for the length.
+     * @tparam Size The length of the chromosome, i.e. twice the number of pairs.
+     */
+    template<uint32_t Size>
+    class FixedTranspositionVectorIndividual {
+        static_assert(Size > 0u && Size % 2u == 0u, "The chromosome must be made of pairs");
+
+        /**
+         * The chromosome, made by an array of unsigned integers.
+         */
+        alignas(64) std::array<uint32_t, Size> chromosome;
+
+    public:
+        /**
+         * Construct an individual whose pairs are all (0,0), i.e. the identity.
+         */
+        FixedTranspositionVectorIndividual() : chromosome{} {}
+
+        /**
+         * Construct from an explicitely given chromosome.
+         * @param chromosome    The transposition chromosome.
+         */
+        FixedTranspositionVectorIndividual(const std::array<uint32_t, Size>& chromosome) : chromosome{chromosome} {}
+
+        /**
+         * Produces a new individual, via biased crossover of this individual with another one.
+         * The crossover is done pair-by-pair.
+         * @param other The other parent individual.
+         * @param bias  Probability that the child inherits each pair from this individual.
+         * @param rng   A random number generator from which the key of the biased coin tosses
+         *              is drawn (see \file CrossoverKernels.h).
+         * @return      The new child.
+         */
+        template<class Rng>
+        FixedTranspositionVectorIndividual biased_crossover_with(const FixedTranspositionVectorIndividual& other, float bias, Rng& rng) const {
+          auto child = FixedTranspositionVectorIndividual{};
+          biased_crossover_into(other, bias, rng, child);
+          return child;
+        }
+
+        /**
+         * Same as \fn biased_crossover_with, but writes the new individual over an existing one.
+         * @param other The other parent individual.
+         * @param bias  Probability of inheriting each pair from this individual.
+         * @param rng   A random number generator used to toss the biased coin.
+         * @param child The individual which will be overwritten by the child.
+         */
+        template<class Rng>
+        void biased_crossover_into(const FixedTranspositionVectorIndividual& other, float bias, Rng& rng, FixedTranspositionVectorIndividual& child) const {
+          assert(0 <= bias && bias <= 1);
+          assert(&child != this && &child != &other);
+
+          crossover::biased_crossover<Size>(chromosome.data(), other.chromosome.data(), child.chromosome.data(), bias, rng,
+                                            crossover::Granularity::Pair);
+        }
+
+        /**
+         * Returns the i-th component of the chromosome.
+         */
+        uint32_t component(uint32_t i) const { return chromosome[i]; }
+
+        /**
+         * Sets the i-th component of the chromosome.
+         */
+        void set_component(uint32_t i, uint32_t value) { chromosome[i] = value; }
+
+        /**
+         * Returns a pointer to the positions of the chromosome, two per pair, e.g. to overwrite them in bulk.
+         */
+        uint32_t* data() { return chromosome.data(); }
+        const uint32_t* data() const { return chromosome.data(); }
+
+        /**
+         * Returns the length of the chromosome.
+         */
+        static constexpr uint32_t size() { return Size; }
+
+        /**
+         * Returns a hash of the chromosome.
+         */
+        uint64_t hash() const { return hash_words(chromosome.data(), Size); }
+    };
+}
+
+#endif //RKBGA_FIXEDTRANSPOSITIONVECTORINDIVIDUAL_H
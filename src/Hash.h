@@ -0,0 +1,44 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_HASH_H
+#define RKBGA_HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace bga {
+    /**
+     * Hashes a sequence of 16 or 32-bit words (e.g. a chromosome, or a decoded permutation) into
+     * a 64-bit value, suitable as a key for \class FitnessCache.
+     * @param words The words to hash.
+     * @param count Number of words.
+     */
+    template<class Word>
+    inline uint64_t hash_words(const Word* words, std::size_t count) {
+        static_assert(sizeof(Word) == sizeof(uint32_t) || sizeof(Word) == sizeof(uint16_t), "Only 16 or 32-bit words can be hashed");
+
+        auto h = 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(count);
+
+        for(auto i = 0u; i < count; i++) {
+            // Use the bit pattern, so that floats can be hashed too.
+            auto word = uint32_t{0};
+            std::memcpy(&word, &words[i], sizeof(Word));
+
+            h ^= word;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+
+        // Final avalanche (from MurmurHash3's fmix64).
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+
+        return h;
+    }
+}
+
+#endif //RKBGA_HASH_H
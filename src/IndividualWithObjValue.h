@@ -14,8 +14,8 @@ namespace bga {
      */
     template<class Individual>
     struct IndividualWithObjValue {
-        const Individual individual;
-        const float objvalue;
+        Individual individual;
+        float objvalue;
 
         IndividualWithObjValue(Individual individual, float objvalue) : individual{individual}, objvalue{objvalue} {}
 
@@ -0,0 +1,265 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_ISLANDSOLVER_H
+#define RKBGA_ISLANDSOLVER_H
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <iterator>
+#include <exception>
+#include "Params.h"
+#include "Random.h"
+#include "Philox.h"
+#include "Solver.h"
+#include "Mailbox.h"
+#include "ParamsBuilder.h"
+#include "DefaultSolverVisitor.h"
+#include "IndividualWithObjValue.h"
+
+namespace bga {
+    /**
+     * Solves a problem with the island model of the Biased Genetic Algorithm: Params::num_islands
+     * independent populations evolve in parallel, each one run by its own thread, and every
+     * Params::migration_freq_generations generations each island sends copies of its
+     * Params::migration_size best individuals to other islands, according to Params::migration_topology
+     * (if Params::migration_freq_generations is 0, islands never migrate). Migrants are posted to
+     * lock-free mailboxes, and each island collects its own mailbox when migrating, so islands never
+     * wait for each other. Collected migrants replace the worst individuals of the receiving island.
+     * Each island evaluates its individuals with Params::num_threads threads; if this is 0, the
+     * hardware threads are shared among the islands.
+     *
+     * The contracts on the template parameters are the same as for \class Solver; furthermore,
+     * \tparam Generator must be copy-constructible, as each island uses its own copy, and the
+     * \tparam Visitor is always called from one thread at a time.
+     */
+    template<   class Generator,
+                class Evaluator,
+                class Visitor = DefaultSolverVisitor<typename Generator::individual_type>,
+                class Rng = Philox4x32>
+    class IslandSolver {
+        using Individual = typename Generator::individual_type;
+        using Island = Solver<Generator, Evaluator, Visitor, Rng>;
+        using Migrants = std::vector<IndividualWithObjValue<Individual>>;
+
+        /**
+         * Genetic Algorithm Parameters.
+         */
+        const Params& params;
+
+        /**
+         * Visitor to be called at certain points during the solution process.
+         */
+        const Visitor& visitor;
+
+        /**
+         * Parameters of each island's solver.
+         */
+        std::vector<Params> island_params;
+
+        /**
+         * Generator of each island.
+         */
+        std::vector<Generator> generators;
+
+        /**
+         * The islands.
+         */
+        std::vector<std::unique_ptr<Island>> islands;
+
+        /**
+         * Mailbox into which other islands post the migrants for each island.
+         */
+        std::vector<std::unique_ptr<Mailbox<Migrants>>> mailboxes;
+
+        /**
+         * Best individual found so far by any island, protected by \member best_mtx.
+         * The mutex also serialises the calls to the visitor.
+         */
+        mutable std::optional<IndividualWithObjValue<Individual>> best;
+        mutable std::mutex best_mtx;
+
+    public:
+        /**
+         * Initialise the island solver.
+         */
+        IslandSolver(const Params& params, const Generator& generator, const Evaluator& evaluator, const Visitor& visitor) :
+            params{params}, visitor{visitor}
+        {
+            const auto num_islands = std::max(params.num_islands, 1u);
+            const auto threads_per_island = (params.num_threads > 0u) ?
+                params.num_threads : std::max(1u, std::thread::hardware_concurrency() / num_islands);
+
+            // Reserve, so that the references held by the islands are not invalidated.
+            island_params.reserve(num_islands);
+            generators.reserve(num_islands);
+
+            for(auto k = 0u; k < num_islands; k++) {
+                island_params.push_back(ParamsBuilder{params}.with_num_islands(1u).with_num_threads(threads_per_island)
+                                            .with_seed(derive_seed(params.seed, k)).build());
+                generators.push_back(generator);
+                islands.push_back(std::make_unique<Island>(island_params[k], generators[k], evaluator, visitor));
+                mailboxes.push_back(std::make_unique<Mailbox<Migrants>>());
+            }
+        }
+
+        /**
+         * Sets individuals to be placed in the initial population of every island
+         * (see \fn Solver::seed_population).
+         */
+        void seed_population(const std::vector<Individual>& individuals) const {
+            for(const auto& island : islands) { island->seed_population(individuals); }
+        }
+
+        /**
+         * Same as the other overload, but with solutions which are encoded into individuals.
+         */
+        template<class Solution, class Encoder>
+        void seed_population(const std::vector<Solution>& solutions, const Encoder& encode) const {
+            for(const auto& island : islands) { island->seed_population(solutions, encode); }
+        }
+
+        /**
+         * Runs the Genetic Algorithm on all islands.
+         * @return  The best individual found.
+         */
+        IndividualWithObjValue<Individual> solve() const {
+            auto start_time = std::chrono::steady_clock::now();
+
+            // Generate the initial populations.
+            run_on_islands([this] (uint32_t k) { islands[k]->initialise(); });
+
+            best.reset();
+            for(const auto& island : islands) { publish(island->best()); }
+
+            // Call the visitor's start action, pass the best individual.
+            visitor.at_start(*best);
+
+            // Number of generations done by the island which did the most.
+            auto generations = std::vector<uint32_t>(islands.size(), 0u);
+
+            run_on_islands([this,&generations,start_time] (uint32_t k) {
+                generations[k] = evolve_island(k, start_time);
+            });
+
+            auto end_time = std::chrono::steady_clock::now();
+            auto total_time_s = std::chrono::duration<float>(end_time - start_time).count();
+
+            // Call the visitor's end action, pass the best individual.
+            visitor.at_end(*best, *std::max_element(generations.begin(), generations.end()), total_time_s);
+
+            // Return the best individual.
+            return *best;
+        }
+
+    private:
+        /**
+         * Calls fn(k) for each island k, each on its own thread, and waits for all of them.
+         * If any call throws, the first exception is rethrown after all threads are joined.
+         */
+        template<class Fn>
+        void run_on_islands(const Fn& fn) const {
+            auto threads = std::vector<std::thread>();
+            auto errors = std::vector<std::exception_ptr>(islands.size());
+
+            for(auto k = 0u; k < islands.size(); k++) {
+                threads.emplace_back([&fn,&errors,k] () {
+                    try { fn(k); } catch(...) { errors[k] = std::current_exception(); }
+                });
+            }
+
+            for(auto& thread : threads) { thread.join(); }
+
+            for(const auto& error : errors) {
+                if(error) { std::rethrow_exception(error); }
+            }
+        }
+
+        /**
+         * Replaces the overall best individual, if the candidate is (strictly) better.
+         */
+        void publish(IndividualWithObjValue<Individual> candidate) const {
+            std::lock_guard<std::mutex> lock{best_mtx};
+            if(!best || candidate.objvalue < best->objvalue) { best = std::move(candidate); }
+        }
+
+        /**
+         * Main loop of an island, which stops according to the same criteria as \class Solver.
+         * @param k             The island.
+         * @param start_time    When the solution process started.
+         * @return              The number of generations done.
+         */
+        uint32_t evolve_island(uint32_t k, std::chrono::steady_clock::time_point start_time) const {
+            const auto& island = *islands[k];
+            uint32_t generation = 0;
+            uint32_t generations_no_improv = 0;
+
+            while(generation < params.max_generations && generations_no_improv < params.max_generations_no_improvement) {
+                auto current_time = std::chrono::steady_clock::now();
+                auto elapsed_time_s = std::chrono::duration<float>(current_time - start_time).count();
+
+                // Check for timeout.
+                if(elapsed_time_s > params.timeout_s) { break; }
+
+                // Evolve!
+                if(island.evolve()) {
+                    generations_no_improv = 0;
+                    publish(island.best());
+                } else {
+                    ++generations_no_improv;
+                }
+
+                if(migrating() && (generation + 1) % params.migration_freq_generations == 0) { migrate(k); }
+
+                // The first island calls the visitor, if requested, passing the overall best individual.
+                if(k == 0u && params.visitor_freq_iterations > 0u && generation > 0 && generation % params.visitor_freq_iterations == 0) {
+                    std::lock_guard<std::mutex> lock{best_mtx};
+                    visitor.at_iteration(*best, generation, elapsed_time_s);
+                }
+
+                ++generation;
+            }
+
+            return generation;
+        }
+
+        /**
+         * Whether islands exchange migrants at all.
+         */
+        bool migrating() const { return islands.size() > 1u && params.migration_freq_generations > 0u; }
+
+        /**
+         * Sends the best individuals of an island to its destinations, and lets the
+         * migrants which other islands sent to it enter its population.
+         * @param k The island.
+         */
+        void migrate(uint32_t k) const {
+            const auto& island = *islands[k];
+            const auto num_islands = static_cast<uint32_t>(islands.size());
+            const auto emigrants = island.best_individuals(params.migration_size);
+
+            if(params.migration_topology == MigrationTopology::Ring) {
+                mailboxes[(k + 1u) % num_islands]->post(emigrants);
+            } else {
+                for(auto j = 0u; j < num_islands; j++) {
+                    if(j != k) { mailboxes[j]->post(emigrants); }
+                }
+            }
+
+            auto immigrants = Migrants();
+            for(auto& migrants : mailboxes[k]->collect()) {
+                std::move(migrants.begin(), migrants.end(), std::back_inserter(immigrants));
+            }
+
+            island.immigrate(std::move(immigrants));
+        }
+    };
+}
+
+#endif //RKBGA_ISLANDSOLVER_H
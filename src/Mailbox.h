@@ -0,0 +1,80 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_MAILBOX_H
+#define RKBGA_MAILBOX_H
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace bga {
+    /**
+     * Lock-free mailbox, to which any number of threads can post messages, and from
+     * which a single thread collects them. Posting pushes the message onto a linked
+     * stack with a compare-and-swap; collecting detaches the whole stack at once, so
+     * neither side ever blocks the other.
+     * @tparam Message  The type of the messages.
+     */
+    template<class Message>
+    class Mailbox {
+        /**
+         * A message in the stack.
+         */
+        struct Node {
+            Message message;
+            Node* next;
+        };
+
+        /**
+         * Most recently posted message, or nullptr if the mailbox is empty.
+         */
+        std::atomic<Node*> head;
+
+        /**
+         * Deletes a detached stack.
+         */
+        static void destroy(Node* node) {
+            while(node != nullptr) {
+                auto next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+
+    public:
+        Mailbox() : head{nullptr} {}
+
+        Mailbox(const Mailbox&) = delete;
+        Mailbox& operator=(const Mailbox&) = delete;
+
+        ~Mailbox() { destroy(head.exchange(nullptr)); }
+
+        /**
+         * Posts a message. Can be called concurrently by any thread.
+         */
+        void post(Message message) {
+            auto node = new Node{std::move(message), head.load(std::memory_order_relaxed)};
+            while(!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+
+        /**
+         * Removes all messages from the mailbox. Must only be called by one thread at a time.
+         * @return  The messages, in the order in which they were posted.
+         */
+        std::vector<Message> collect() {
+            auto messages = std::vector<Message>();
+            auto node = head.exchange(nullptr, std::memory_order_acquire);
+
+            for(auto it = node; it != nullptr; it = it->next) { messages.push_back(std::move(it->message)); }
+            destroy(node);
+
+            std::reverse(messages.begin(), messages.end());
+            return messages;
+        }
+    };
+}
+
+#endif //RKBGA_MAILBOX_H
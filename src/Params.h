@@ -5,9 +5,26 @@
 #ifndef RKBGA_PARAMS_H
 #define RKBGA_PARAMS_H
 
+#include <string>
+#include <utility>
 #include <cstdint>
 
 namespace bga {
+    /**
+     * How islands exchange individuals, in the island model (see \class IslandSolver).
+     */
+    enum class MigrationTopology {
+        /**
+         * Island i sends its migrants to island i+1 (and the last island to the first).
+         */
+        Ring,
+
+        /**
+         * Each island sends its migrants to all other islands.
+         */
+        AllToAll
+    };
+
     /**
      * Parameters for the Biased Genetic Algorithm.
      */
@@ -49,17 +66,97 @@ namespace bga {
 
         /**
          * How often should we call the visitor? (In number of iterations).
+         * If 0, it is only called at the start and at the end.
          */
         const uint32_t visitor_freq_iterations;
 
+        /**
+         * Number of threads used to evaluate individuals, including the solver's own thread.
+         * If 0, use as many threads as the hardware supports.
+         */
+        const uint32_t num_threads;
+
+        /**
+         * Maximum number of objective values stored in the evaluation cache.
+         * If 0, the cache is disabled.
+         */
+        const uint32_t cache_size;
+
+        /**
+         * Number of islands, i.e. of independent populations (only used by \class IslandSolver).
+         */
+        const uint32_t num_islands;
+
+        /**
+         * How often do islands send migrants to each other? (In number of generations).
+         * If 0, islands never migrate, and evolve independently.
+         */
+        const uint32_t migration_freq_generations;
+
+        /**
+         * Number of elite individuals that an island sends to each destination at each migration.
+         */
+        const uint32_t migration_size;
+
+        /**
+         * Destinations of the migrants of each island.
+         */
+        const MigrationTopology migration_topology;
+
+        /**
+         * Seed of the random number generators used by the solver. Two runs with the same seed
+         * produce the same result, regardless of the number of threads (provided that the
+         * generator and the evaluator are deterministic, and with the exception of the
+         * island models, in which migration timing depends on thread scheduling).
+         */
+        const uint64_t seed;
+
+        /**
+         * How often is the elite improved by local search? (In number of generations).
+         * If 0, the elite is never improved (see \class Solver, contract 8).
+         */
+        const uint32_t improvement_freq_generations;
+
+        /**
+         * Number of best individuals improved by local search, each time the elite is improved.
+         */
+        const uint32_t improvement_size;
+
+        /**
+         * How often is the population saved to \member checkpoint_file? (In number of generations).
+         * If 0, it is never saved (see \class Solver and \file Checkpoint.h).
+         */
+        const uint32_t checkpoint_freq_generations;
+
+        /**
+         * File to which the population is saved.
+         */
+        const std::string checkpoint_file;
+
+        /**
+         * Whether the new individuals of each generation are evaluated as soon as they are created,
+         * rather than after all of them are (see \class Solver, contract 10).
+         */
+        const bool pipelined_generations;
+
         Params( uint32_t population_size, float elite_share, float replace_share,
                 float crossover_elite_bias, uint32_t max_generations,
                 uint32_t max_generations_no_improvement, uint32_t timeout_s,
-                uint32_t visitor_freq_iterations) :
+                uint32_t visitor_freq_iterations, uint32_t num_threads = 0, uint32_t cache_size = 0,
+                uint32_t num_islands = 1, uint32_t migration_freq_generations = 100, uint32_t migration_size = 2,
+                MigrationTopology migration_topology = MigrationTopology::Ring, uint64_t seed = 0,
+                uint32_t improvement_freq_generations = 0,
+                uint32_t improvement_size = 1, uint32_t checkpoint_freq_generations = 0,
+                std::string checkpoint_file = "", bool pipelined_generations = false) :
                 population_size{population_size}, elite_share{elite_share}, replace_share{replace_share},
                 crossover_elite_bias{crossover_elite_bias}, max_generations{max_generations},
                 max_generations_no_improvement{max_generations_no_improvement}, timeout_s{timeout_s},
-                visitor_freq_iterations{visitor_freq_iterations} {}
+                visitor_freq_iterations{visitor_freq_iterations}, num_threads{num_threads}, cache_size{cache_size},
+                num_islands{num_islands}, migration_freq_generations{migration_freq_generations},
+                migration_size{migration_size}, migration_topology{migration_topology}, seed{seed},
+                improvement_freq_generations{improvement_freq_generations},
+                improvement_size{improvement_size}, checkpoint_freq_generations{checkpoint_freq_generations},
+                checkpoint_file{std::move(checkpoint_file)}, pipelined_generations{pipelined_generations} {}
     };
 }
 
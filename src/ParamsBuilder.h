@@ -5,9 +5,12 @@
 #ifndef RKBGA_PARAMSBUILDER_H
 #define RKBGA_PARAMSBUILDER_H
 
-#include <cstdint>
+#include <string>
 #include <limits>
+#include <cstdint>
+#include <utility>
 #include "Params.h"
+#include "Random.h"
 
 namespace bga {
     /**
@@ -22,15 +25,56 @@ namespace bga {
         uint32_t max_generations_no_improvement;
         uint32_t timeout_s;
         uint32_t visitor_freq_iterations;
+        uint32_t num_threads;
+        uint32_t cache_size;
+        uint32_t num_islands;
+        uint32_t migration_freq_generations;
+        uint32_t migration_size;
+        MigrationTopology migration_topology;
+        uint64_t seed;
+        uint32_t improvement_freq_generations;
+        uint32_t improvement_size;
+        uint32_t checkpoint_freq_generations;
+        std::string checkpoint_file;
+        bool pipelined_generations;
 
     public:
         /**
          * Initialises the builder with default values for the parameters.
+         * The default seed is drawn from the system's random device.
          */
         ParamsBuilder() :   population_size{250}, elite_share{0.2}, replace_share{0.1},
                             crossover_elite_bias{0.7}, max_generations{std::numeric_limits<uint32_t>::max()},
                             max_generations_no_improvement{std::numeric_limits<uint32_t>::max()},
-                            timeout_s{std::numeric_limits<uint32_t>::max()}, visitor_freq_iterations{1000} {}
+                            timeout_s{std::numeric_limits<uint32_t>::max()}, visitor_freq_iterations{1000},
+                            num_threads{0}, cache_size{0}, num_islands{1}, migration_freq_generations{100},
+                            migration_size{2}, migration_topology{MigrationTopology::Ring},
+                            seed{random_seed()},
+                            improvement_freq_generations{0},
+                            improvement_size{1},
+                            checkpoint_freq_generations{0},
+                            checkpoint_file{},
+                            pipelined_generations{false} {}
+
+        /**
+         * Initialises the builder with the values of existing parameters, e.g. to derive
+         * a slightly different set of parameters from them.
+         */
+        explicit ParamsBuilder(const Params& params) :
+                            population_size{params.population_size}, elite_share{params.elite_share},
+                            replace_share{params.replace_share}, crossover_elite_bias{params.crossover_elite_bias},
+                            max_generations{params.max_generations},
+                            max_generations_no_improvement{params.max_generations_no_improvement},
+                            timeout_s{params.timeout_s}, visitor_freq_iterations{params.visitor_freq_iterations},
+                            num_threads{params.num_threads}, cache_size{params.cache_size},
+                            num_islands{params.num_islands}, migration_freq_generations{params.migration_freq_generations},
+                            migration_size{params.migration_size}, migration_topology{params.migration_topology},
+                            seed{params.seed},
+                            improvement_freq_generations{params.improvement_freq_generations},
+                            improvement_size{params.improvement_size},
+                            checkpoint_freq_generations{params.checkpoint_freq_generations},
+                            checkpoint_file{params.checkpoint_file},
+                            pipelined_generations{params.pipelined_generations} {}
 
         ParamsBuilder& with_population_size(uint32_t population_size) { this->population_size = population_size; return *this; }
         ParamsBuilder& with_elite_share(float elite_share) { this->elite_share = elite_share; return *this; }
@@ -40,7 +84,19 @@ namespace bga {
         ParamsBuilder& with_max_generations_no_improvement(uint32_t max_generations_no_improvement) { this->max_generations_no_improvement = max_generations_no_improvement; return *this; }
         ParamsBuilder& with_timeout_s(uint32_t timeout_s) { this->timeout_s = timeout_s; return *this; }
         ParamsBuilder& with_visitor_freq_iterations(uint32_t visitor_freq_iterations) { this->visitor_freq_iterations = visitor_freq_iterations; return *this; }
-        Params build() { return Params{population_size, elite_share, replace_share, crossover_elite_bias, max_generations, max_generations_no_improvement, timeout_s, visitor_freq_iterations}; }
+        ParamsBuilder& with_num_threads(uint32_t num_threads) { this->num_threads = num_threads; return *this; }
+        ParamsBuilder& with_cache_size(uint32_t cache_size) { this->cache_size = cache_size; return *this; }
+        ParamsBuilder& with_num_islands(uint32_t num_islands) { this->num_islands = num_islands; return *this; }
+        ParamsBuilder& with_migration_freq_generations(uint32_t migration_freq_generations) { this->migration_freq_generations = migration_freq_generations; return *this; }
+        ParamsBuilder& with_migration_size(uint32_t migration_size) { this->migration_size = migration_size; return *this; }
+        ParamsBuilder& with_migration_topology(MigrationTopology migration_topology) { this->migration_topology = migration_topology; return *this; }
+        ParamsBuilder& with_seed(uint64_t seed) { this->seed = seed; return *this; }
+        ParamsBuilder& with_improvement_freq_generations(uint32_t improvement_freq_generations) { this->improvement_freq_generations = improvement_freq_generations; return *this; }
+        ParamsBuilder& with_improvement_size(uint32_t improvement_size) { this->improvement_size = improvement_size; return *this; }
+        ParamsBuilder& with_checkpoint_freq_generations(uint32_t checkpoint_freq_generations) { this->checkpoint_freq_generations = checkpoint_freq_generations; return *this; }
+        ParamsBuilder& with_checkpoint_file(std::string checkpoint_file) { this->checkpoint_file = std::move(checkpoint_file); return *this; }
+        ParamsBuilder& with_pipelined_generations(bool pipelined_generations) { this->pipelined_generations = pipelined_generations; return *this; }
+        Params build() { return Params{population_size, elite_share, replace_share, crossover_elite_bias, max_generations, max_generations_no_improvement, timeout_s, visitor_freq_iterations, num_threads, cache_size, num_islands, migration_freq_generations, migration_size, migration_topology, seed, improvement_freq_generations, improvement_size, checkpoint_freq_generations, checkpoint_file, pipelined_generations}; }
     };
 }
 
@@ -0,0 +1,63 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_PCG64_H
+#define RKBGA_PCG64_H
+
+#include <limits>
+#include <cstdint>
+#include "Random.h"
+
+namespace bga {
+    /**
+     * The PCG64 generator (O'Neill, "PCG: a family of simple fast space-efficient statistically
+     * good algorithms for random number generation", 2014), i.e. a 128-bit linear congruential
+     * generator whose state is scrambled by an xor-shift and a random rotation (XSL-RR) into 64
+     * random bits per call. The increment of the LCG is derived from the stream identifier, so
+     * different streams are genuinely different sequences.
+     * It satisfies the UniformRandomBitGenerator requirements. It needs 128-bit integers, which
+     * GCC and Clang provide on 64-bit targets.
+     */
+    class Pcg64 {
+        using uint128 = unsigned __int128;
+
+        uint128 state;
+        uint128 increment;
+
+        static constexpr uint128 multiplier = (static_cast<uint128>(0x2360ED051FC65DA4ull) << 64u) | 0x4385DF649FCCF645ull;
+
+        void step() { state = state * multiplier + increment; }
+
+    public:
+        using result_type = uint64_t;
+
+        /**
+         * Creates a stream.
+         * @param seed      The seed, shared by all streams of a run.
+         * @param stream    Identifier of the stream.
+         */
+        Pcg64(uint64_t seed, uint64_t stream) : state{0u}, increment{(static_cast<uint128>(stream) << 1u) | 1u} {
+            step();
+            state += (static_cast<uint128>(derive_seed(seed, 0u)) << 64u) | seed;
+            step();
+        }
+
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        /**
+         * Returns the next 64 random bits of the stream.
+         */
+        result_type operator()() {
+            step();
+
+            const auto rotation = static_cast<unsigned>(state >> 122u);
+            const auto x = static_cast<uint64_t>(state >> 64u) ^ static_cast<uint64_t>(state);
+
+            return (x >> rotation) | (x << ((64u - rotation) & 63u));
+        }
+    };
+}
+
+#endif //RKBGA_PCG64_H
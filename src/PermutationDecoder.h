@@ -0,0 +1,173 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_PERMUTATIONDECODER_H
+#define RKBGA_PERMUTATIONDECODER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+namespace bga {
+    /**
+     * Decoding of random keys into permutations, which is the first step of most random-key evaluators.
+     * Each key is packed with its position into a 64-bit word, whose high half is an order-preserving
+     * integer image of the key: sorting the words sorts the keys, with ties broken by position, and
+     * the low halves of the sorted words are the permutation. The words are sorted by a branchless
+     * sorting network for short chromosomes, by std::sort for medium ones, and by an LSD radix sort
+     * for long ones. The buffers are kept per thread, so decoding does not allocate memory.
+     */
+    namespace decoding {
+        /**
+         * Chromosomes up to this length are sorted by a sorting network.
+         */
+        constexpr uint32_t sorting_network_max_size = 32u;
+
+        /**
+         * Chromosomes of at least this length are sorted by radix sort.
+         */
+        constexpr uint32_t radix_sort_min_size = 512u;
+
+        /**
+         * Width, in bits, of the digits of the radix sort: three passes cover the 32-bit keys.
+         */
+        constexpr uint32_t radix_bits = 11u;
+
+        /**
+         * Buffers reused by all the decodings done by one thread.
+         */
+        struct Scratch {
+            std::vector<uint64_t> packed;
+            std::vector<uint64_t> buffer;
+            std::vector<uint32_t> histogram;
+        };
+
+        /**
+         * The buffers of the calling thread.
+         */
+        inline Scratch& thread_scratch() {
+            thread_local auto scratch = Scratch{};
+            return scratch;
+        }
+
+        /**
+         * Maps a float to an unsigned integer with the same order (for all floats but NaNs): the sign
+         * bit of non-negative floats is set, and all bits of negative floats are flipped.
+         */
+        inline uint32_t ordered_bits(float key) {
+            auto bits = uint32_t{0};
+            std::memcpy(&bits, &key, sizeof(float));
+            return bits ^ ((bits >> 31u) ? 0xFFFFFFFFu : 0x80000000u);
+        }
+
+        /**
+         * Sorts at most \member sorting_network_max_size words with a bitonic network, padded with the
+         * largest word to the next power of two. Compare-exchanges are branchless, so the sort takes
+         * the same time whatever the keys, and the compiler is free to vectorise each stage.
+         */
+        inline void sorting_network(uint64_t* words, uint32_t size) {
+            assert(size <= sorting_network_max_size);
+
+            auto width = 1u;
+            while(width < size) { width <<= 1u; }
+
+            uint64_t padded[sorting_network_max_size];
+            std::copy(words, words + size, padded);
+            std::fill(padded + size, padded + width, UINT64_MAX);
+
+            for(auto k = 2u; k <= width; k <<= 1u) {
+                for(auto j = k >> 1u; j > 0u; j >>= 1u) {
+                    for(auto i = 0u; i < width; i++) {
+                        const auto l = i ^ j;
+                        if(l <= i) { continue; }
+
+                        const auto low = std::min(padded[i], padded[l]);
+                        const auto high = std::max(padded[i], padded[l]);
+                        const auto ascending = (i & k) == 0u;
+
+                        padded[i] = ascending ? low : high;
+                        padded[l] = ascending ? high : low;
+                    }
+                }
+            }
+
+            std::copy(padded, padded + size, words);
+        }
+
+        /**
+         * Sorts words by their high half with an LSD radix sort, stable with respect to the initial order.
+         * Passes on digits which are the same for all the words are skipped.
+         * @param words     The words to sort; they are sorted in place.
+         * @param buffer    A buffer of the same size.
+         * @param histogram A buffer for the digit counts.
+         * @param size      Number of words.
+         */
+        inline void radix_sort(uint64_t* words, uint64_t* buffer, std::vector<uint32_t>& histogram, uint32_t size) {
+            constexpr auto digits = 1u << radix_bits;
+            constexpr auto digit_mask = digits - 1u;
+
+            auto* from = words;
+            auto* to = buffer;
+
+            for(auto shift = 32u; shift < 64u; shift += radix_bits) {
+                histogram.assign(digits, 0u);
+                for(auto i = 0u; i < size; i++) { ++histogram[(from[i] >> shift) & digit_mask]; }
+
+                if(histogram[(from[0] >> shift) & digit_mask] == size) { continue; }
+
+                auto total = 0u;
+                for(auto& offset : histogram) {
+                    const auto count = offset;
+                    offset = total;
+                    total += count;
+                }
+
+                for(auto i = 0u; i < size; i++) { to[histogram[(from[i] >> shift) & digit_mask]++] = from[i]; }
+                std::swap(from, to);
+            }
+
+            if(from != words) { std::copy(from, from + size, words); }
+        }
+    }
+
+    /**
+     * Writes the permutation encoded by a sequence of random keys, i.e. the positions of the keys
+     * sorted by increasing key, ties broken by position.
+     * @param keys          The keys; they must not be NaN.
+     * @param size          Number of keys.
+     * @param permutation   The output; it must have room for \param size positions.
+     */
+    inline void decode_permutation(const float* keys, uint32_t size, uint32_t* permutation) {
+        if(size == 0u) { return; }
+
+        auto& scratch = decoding::thread_scratch();
+        scratch.packed.resize(size);
+
+        auto* packed = scratch.packed.data();
+        for(auto i = 0u; i < size; i++) { packed[i] = (static_cast<uint64_t>(decoding::ordered_bits(keys[i])) << 32u) | i; }
+
+        if(size <= decoding::sorting_network_max_size) {
+            decoding::sorting_network(packed, size);
+        } else if(size < decoding::radix_sort_min_size) {
+            std::sort(packed, packed + size);
+        } else {
+            scratch.buffer.resize(size);
+            decoding::radix_sort(packed, scratch.buffer.data(), scratch.histogram, size);
+        }
+
+        for(auto i = 0u; i < size; i++) { permutation[i] = static_cast<uint32_t>(packed[i]); }
+    }
+
+    /**
+     * Same as the other overload, but resizes the output vector to the number of keys.
+     */
+    inline void decode_permutation(const float* keys, uint32_t size, std::vector<uint32_t>& permutation) {
+        permutation.resize(size);
+        decode_permutation(keys, size, permutation.data());
+    }
+}
+
+#endif //RKBGA_PERMUTATIONDECODER_H
@@ -0,0 +1,97 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_PERMUTATIONENCODER_H
+#define RKBGA_PERMUTATIONENCODER_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "RandomVectorIndividual.h"
+#include "TranspositionVectorIndividual.h"
+
+namespace bga {
+    /**
+     * Encodes a permutation into random keys, so that they decode to it (see \fn decode_permutation):
+     * the keys which are already in \param keys are sorted, and the k-th smallest one is given to
+     * the position permutation[k]. Reusing the keys keeps their distribution, e.g. after a local
+     * search has changed the permutation an individual decodes to.
+     * @param permutation   The permutation.
+     * @param size          Its length, i.e. the number of keys.
+     * @param keys          Input: the keys to redistribute; output: the keys encoding the permutation.
+     */
+    inline void encode_permutation(const uint32_t* permutation, uint32_t size, float* keys) {
+        thread_local auto sorted = std::vector<float>();
+        sorted.assign(keys, keys + size);
+        std::sort(sorted.begin(), sorted.end());
+
+        for(auto k = 0u; k < size; k++) { keys[permutation[k]] = sorted[k]; }
+    }
+
+    /**
+     * Encodes a permutation into evenly spaced random keys in (0,1), e.g. to build a new individual from it.
+     * @param permutation   The permutation.
+     * @param size          Its length, i.e. the number of keys.
+     * @param keys          Output: the keys encoding the permutation.
+     */
+    inline void encode_permutation_evenly(const uint32_t* permutation, uint32_t size, float* keys) {
+        for(auto k = 0u; k < size; k++) { keys[permutation[k]] = (static_cast<float>(k) + 0.5f) / static_cast<float>(size); }
+    }
+
+    /**
+     * Encodes a permutation into a sequence of size-1 transpositions, i.e. pairs (i,j) which, applied
+     * in order as swaps of the elements in positions i and j of the identity, give the permutation
+     * (see \class TranspositionVectorIndividual). Pairs (i,i) are kept, to give the sequence fixed length.
+     * @param permutation   The permutation.
+     * @param size          Its length; must be positive.
+     * @param pairs         Output: 2 * (size-1) positions, two for each pair.
+     */
+    inline void encode_transpositions(const uint32_t* permutation, uint32_t size, uint32_t* pairs) {
+        // Current arrangement, and position of each element in it.
+        thread_local auto current = std::vector<uint32_t>();
+        thread_local auto position = std::vector<uint32_t>();
+        current.resize(size);
+        position.resize(size);
+
+        for(auto i = 0u; i < size; i++) { current[i] = position[i] = i; }
+
+        // Bring the right element in each position, as selection sort does.
+        for(auto i = 0u; i + 1u < size; i++) {
+            const auto j = position[permutation[i]];
+
+            pairs[2u * i] = i;
+            pairs[2u * i + 1u] = j;
+
+            std::swap(current[i], current[j]);
+            position[current[i]] = i;
+            position[current[j]] = j;
+        }
+    }
+
+    /**
+     * Builds the random-key individual which decodes to a permutation, e.g. to seed the initial
+     * population with a known solution (see \fn Solver::seed_population).
+     */
+    struct RandomKeyEncoder {
+        RandomVectorIndividual operator()(const std::vector<uint32_t>& permutation) const {
+            auto keys = std::vector<float>(permutation.size());
+            encode_permutation_evenly(permutation.data(), static_cast<uint32_t>(permutation.size()), keys.data());
+            return RandomVectorIndividual{std::move(keys)};
+        }
+    };
+
+    /**
+     * Builds the transposition individual which decodes to a permutation, e.g. to seed the initial
+     * population with a known solution (see \fn Solver::seed_population).
+     */
+    struct TranspositionEncoder {
+        TranspositionVectorIndividual operator()(const std::vector<uint32_t>& permutation) const {
+            auto pairs = std::vector<uint32_t>(2u * (permutation.size() - 1u));
+            encode_transpositions(permutation.data(), static_cast<uint32_t>(permutation.size()), pairs.data());
+            return TranspositionVectorIndividual{std::move(pairs)};
+        }
+    };
+}
+
+#endif //RKBGA_PERMUTATIONENCODER_H
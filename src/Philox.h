@@ -0,0 +1,92 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_PHILOX_H
+#define RKBGA_PHILOX_H
+
+#include <array>
+#include <limits>
+#include <cstdint>
+
+namespace bga {
+    /**
+     * Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers:
+     * as easy as 1, 2, 3", 2011). Its output is a bijective function of a 128-bit counter and a
+     * 64-bit key, so any number of independent streams can be created cheaply and deterministically
+     * from a seed (the key) and a stream id (the upper half of the counter): the solver gives each
+     * individual of each generation its own stream, which makes runs reproducible regardless of
+     * how the work is split among threads.
+     * It satisfies the UniformRandomBitGenerator requirements, so it can be used with the
+     * distributions of <random> in place of std::mt19937.
+     */
+    class Philox4x32 {
+        /**
+         * The key.
+         */
+        std::array<uint32_t, 2> key;
+
+        /**
+         * The counter; the first two words are incremented, the last two identify the stream.
+         */
+        std::array<uint32_t, 4> counter;
+
+        /**
+         * Output of the last block, and position of the next unused word in it.
+         */
+        std::array<uint32_t, 4> block;
+        uint32_t position;
+
+        /**
+         * Computes the block for the current counter, and advances the counter.
+         */
+        void next_block() {
+            auto c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+            auto k0 = key[0], k1 = key[1];
+
+            for(auto r = 0u; r < 10u; r++) {
+                const auto p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+                const auto p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+
+                c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                c1 = static_cast<uint32_t>(p1);
+                c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                c3 = static_cast<uint32_t>(p0);
+
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+
+            block = {{c0, c1, c2, c3}};
+            position = 0u;
+
+            if(++counter[0] == 0u) { ++counter[1]; }
+        }
+
+    public:
+        using result_type = uint32_t;
+
+        /**
+         * Creates a stream.
+         * @param seed      The seed, shared by all streams of a run.
+         * @param stream    Identifier of the stream.
+         */
+        Philox4x32(uint64_t seed, uint64_t stream) :
+            key{{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}},
+            counter{{0u, 0u, static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)}},
+            block{}, position{4u} {}
+
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        /**
+         * Returns the next 32 random bits of the stream.
+         */
+        result_type operator()() {
+            if(position == 4u) { next_block(); }
+            return block[position++];
+        }
+    };
+}
+
+#endif //RKBGA_PHILOX_H
@@ -0,0 +1,171 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_POPULATION_H
+#define RKBGA_POPULATION_H
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <numeric>
+#include <algorithm>
+#include "Span.h"
+#include "IndividualWithObjValue.h"
+
+namespace bga {
+    /**
+     * Contiguous store for the individuals of a generation, together with their objective values.
+     * Individuals are kept in slots, in the order in which they were added, and an index
+     * permutation gives their ranking. The ranking is only partially sorted (see \fn rank), which
+     * is all the Genetic Algorithm needs, and gives constant-time access to the k-th ranked individual.
+     * Slots can be overwritten in place, so that two populations can be used as double buffers
+     * for consecutive generations, without allocating memory.
+     * @tparam Individual   The individual used in the Genetic Algorithm.
+     */
+    template<class Individual>
+    class Population {
+        /**
+         * The individuals, in insertion order.
+         */
+        std::vector<Individual> individuals;
+
+        /**
+         * Objective value of each individual.
+         */
+        std::vector<float> objvalues;
+
+        /**
+         * The k-th entry is the position, in \member individuals, of the k-th ranked individual.
+         */
+        std::vector<uint32_t> ranking;
+
+    public:
+        /**
+         * Reserves space for a given number of individuals.
+         */
+        void reserve(uint32_t size) {
+            individuals.reserve(size);
+            objvalues.reserve(size);
+            ranking.reserve(size);
+        }
+
+        /**
+         * Adds an individual to the population, in last position in the ranking.
+         * @param individual    The new individual.
+         * @param objvalue      Its objective value.
+         */
+        void add(Individual individual, float objvalue) {
+            ranking.push_back(static_cast<uint32_t>(individuals.size()));
+            individuals.push_back(std::move(individual));
+            objvalues.push_back(objvalue);
+        }
+
+        /**
+         * Number of individuals in the population.
+         */
+        uint32_t size() const { return static_cast<uint32_t>(individuals.size()); }
+
+        /**
+         * Returns the individual stored in a given slot (i.e., position in insertion order).
+         */
+        Individual& individual(uint32_t slot) { return individuals[slot]; }
+        const Individual& individual(uint32_t slot) const { return individuals[slot]; }
+
+        /**
+         * Returns the objective value of the individual stored in a given slot.
+         */
+        float objvalue(uint32_t slot) const { return objvalues[slot]; }
+
+        /**
+         * Sets the objective value of the individual stored in a given slot.
+         * This invalidates the ranking, until the next call to \fn rank.
+         */
+        void set_objvalue(uint32_t slot, float objvalue) { objvalues[slot] = objvalue; }
+
+        /**
+         * Exchanges the contents (individual and objective value) of two slots.
+         * This invalidates the ranking, until the next call to \fn rank.
+         */
+        void swap_slots(uint32_t slot1, uint32_t slot2) {
+            using std::swap;
+            swap(individuals[slot1], individuals[slot2]);
+            swap(objvalues[slot1], objvalues[slot2]);
+        }
+
+        /**
+         * Returns a view over the individuals in slots [begin, end).
+         */
+        Span<const Individual> individuals_in(uint32_t begin, uint32_t end) const {
+            assert(begin <= end && end <= size());
+            return Span<const Individual>{individuals.data() + begin, end - begin};
+        }
+
+        /**
+         * Returns a view over the objective values of the individuals in slots [begin, end).
+         * Writing them invalidates the ranking, until the next call to \fn rank.
+         */
+        Span<float> objvalues_in(uint32_t begin, uint32_t end) {
+            assert(begin <= end && end <= size());
+            return Span<float>{objvalues.data() + begin, end - begin};
+        }
+
+        /**
+         * Ranks the individuals by objective value, doing just enough work for the Genetic Algorithm.
+         * Afterwards, the first \param elite_size ranks hold the best individuals in sorted order;
+         * the ranks up to \param parents_size hold the following individuals, in no particular order;
+         * the remaining ranks hold the worst individuals, in no particular order.
+         * Ties are broken by insertion order, and the ranking is computed from scratch, so that it only
+         * depends on the objective values in the slots (and not, e.g., on the previous ranking).
+         * @param elite_size    Number of elite individuals.
+         * @param parents_size  Number of best individuals which are separated from the worst ones.
+         */
+        void rank(uint32_t elite_size, uint32_t parents_size) {
+            assert(elite_size <= parents_size && parents_size <= size());
+
+            auto better = [this] (uint32_t i, uint32_t j) {
+                return objvalues[i] < objvalues[j] || (objvalues[i] == objvalues[j] && i < j);
+            };
+
+            std::iota(ranking.begin(), ranking.end(), 0u);
+
+            const auto elite_end = ranking.begin() + elite_size;
+            const auto parents_end = ranking.begin() + parents_size;
+
+            if(parents_end != ranking.end()) { std::nth_element(ranking.begin(), parents_end, ranking.end(), better); }
+            if(elite_end != parents_end) { std::nth_element(ranking.begin(), elite_end, parents_end, better); }
+            std::sort(ranking.begin(), elite_end, better);
+
+            // Even with no elite, the best individual must come first.
+            if(elite_size == 0 && !ranking.empty()) {
+                std::iter_swap(ranking.begin(), std::min_element(ranking.begin(), ranking.end(), better));
+            }
+        }
+
+        /**
+         * Returns the slot of the k-th ranked individual.
+         */
+        uint32_t ranked_slot(uint32_t k) const { return ranking[k]; }
+
+        /**
+         * Returns the k-th ranked individual.
+         */
+        const Individual& ranked_individual(uint32_t k) const { return individuals[ranking[k]]; }
+
+        /**
+         * Returns the objective value of the k-th ranked individual.
+         */
+        float ranked_objvalue(uint32_t k) const { return objvalues[ranking[k]]; }
+
+        /**
+         * Returns the best individual together with its objective value.
+         * The population must have been ranked.
+         */
+        IndividualWithObjValue<Individual> best() const {
+            assert(!individuals.empty());
+            return IndividualWithObjValue<Individual>(ranked_individual(0), ranked_objvalue(0));
+        }
+    };
+}
+
+#endif //RKBGA_POPULATION_H
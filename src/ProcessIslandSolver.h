@@ -0,0 +1,216 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_PROCESSISLANDSOLVER_H
+#define RKBGA_PROCESSISLANDSOLVER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+#include "Params.h"
+#include "Solver.h"
+#include "Random.h"
+#include "Philox.h"
+#include "ParamsBuilder.h"
+#include "WireFormat.h"
+#include "SocketChannel.h"
+#include "DefaultSolverVisitor.h"
+#include "IndividualWithObjValue.h"
+
+namespace bga {
+    /**
+     * Solves a problem with the island model of the Biased Genetic Algorithm, where each island
+     * is a separate process, possibly started independently of the others on the same machine.
+     * All processes are given the same list of endpoints (see \class SocketChannel), and each
+     * one listens on the endpoint with its own index. Every Params::migration_freq_generations
+     * generations, each process serialises its Params::migration_size best individuals (see
+     * \file WireFormat.h) and sends them to other processes, according to Params::migration_topology;
+     * then it lets the individuals received in the meantime replace its worst ones. If
+     * Params::migration_freq_generations is 0, processes never migrate.
+     * Sending and receiving never block, so a slow or missing process does not stall the others.
+     *
+     * The contracts on the template parameters are the same as for \class Solver; furthermore,
+     * \class WireCodec must be specialised for the individual type.
+     */
+    template<   class Generator,
+                class Evaluator,
+                class Visitor = DefaultSolverVisitor<typename Generator::individual_type>,
+                class Rng = Philox4x32>
+    class ProcessIslandSolver {
+        using Individual = typename Generator::individual_type;
+        using Migrants = std::vector<IndividualWithObjValue<Individual>>;
+
+        /**
+         * Genetic Algorithm Parameters.
+         */
+        const Params& params;
+
+        /**
+         * Visitor to be called at certain points during the solution process.
+         */
+        const Visitor& visitor;
+
+        /**
+         * Parameters of the island run by this process, whose seed is derived from the
+         * common one and the process' index.
+         */
+        const Params island_params;
+
+        /**
+         * The island run by this process.
+         */
+        const Solver<Generator, Evaluator, Visitor, Rng> island;
+
+        /**
+         * Index of this process' endpoint.
+         */
+        const uint32_t own_index;
+
+        /**
+         * Total number of processes.
+         */
+        const uint32_t num_processes;
+
+        /**
+         * Channel to the other processes. Its peers are the other endpoints, in the same order.
+         */
+        mutable SocketChannel channel;
+
+        /**
+         * Number of genes of the individuals, against which those received are checked.
+         */
+        mutable uint32_t chromosome_size;
+
+    public:
+        /**
+         * Initialise the solver, and start listening on the own endpoint.
+         * @param endpoints     Endpoints of all processes.
+         * @param own_index     Index of this process' endpoint.
+         */
+        ProcessIslandSolver(const Params& params, const Generator& generator, const Evaluator& evaluator, const Visitor& visitor,
+                            const std::vector<std::string>& endpoints, uint32_t own_index) :
+            params{params}, visitor{visitor},
+            island_params{ParamsBuilder{params}.with_seed(derive_seed(params.seed, own_index)).build()},
+            island{island_params, generator, evaluator, visitor}, own_index{own_index},
+            num_processes{static_cast<uint32_t>(endpoints.size())}, channel{endpoint_at(endpoints, own_index), other_endpoints(endpoints, own_index)}, chromosome_size{0u} {}
+
+        /**
+         * Sets individuals to be placed in the initial population of this process' island
+         * (see \fn Solver::seed_population).
+         */
+        void seed_population(std::vector<Individual> individuals) const {
+            island.seed_population(std::move(individuals));
+        }
+
+        /**
+         * Same as the other overload, but with solutions which are encoded into individuals.
+         */
+        template<class Solution, class Encoder>
+        void seed_population(const std::vector<Solution>& solutions, const Encoder& encode) const {
+            island.seed_population(solutions, encode);
+        }
+
+        /**
+         * Runs the Genetic Algorithm on this process' island.
+         * @return  The best individual found by this process (including those received from others).
+         */
+        IndividualWithObjValue<Individual> solve() const {
+            uint32_t generation = 0;
+            uint32_t generations_no_improv = 0;
+
+            auto start_time = std::chrono::steady_clock::now();
+
+            // Generate the initial population.
+            island.initialise();
+            chromosome_size = static_cast<uint32_t>(island.best().individual.size());
+
+            // Call the visitor's start action, pass the best individual.
+            visitor.at_start(island.best());
+
+            while(generation < params.max_generations && generations_no_improv < params.max_generations_no_improvement) {
+                auto current_time = std::chrono::steady_clock::now();
+                auto elapsed_time_s = std::chrono::duration<float>(current_time - start_time).count();
+
+                // Check for timeout.
+                if(elapsed_time_s > params.timeout_s) { break; }
+
+                // Evolve!
+                if(island.evolve()) { generations_no_improv = 0; }
+                else { ++generations_no_improv; }
+
+                if(migrating() && (generation + 1) % params.migration_freq_generations == 0) { migrate(); }
+                else { channel.flush(); }
+
+                // Call the visitor, if requested.
+                if(params.visitor_freq_iterations > 0u && generation > 0 && generation % params.visitor_freq_iterations == 0) { visitor.at_iteration(island.best(), generation, elapsed_time_s); }
+
+                ++generation;
+            }
+
+            auto end_time = std::chrono::steady_clock::now();
+            auto total_time_s = std::chrono::duration<float>(end_time - start_time).count();
+
+            // Call the visitor's end action, pass the best individual.
+            visitor.at_end(island.best(), generation, total_time_s);
+
+            // Return the best individual.
+            return island.best();
+        }
+
+    private:
+        static std::string endpoint_at(const std::vector<std::string>& endpoints, uint32_t index) {
+            if(index >= endpoints.size()) { throw std::invalid_argument("Endpoint index out of range"); }
+            return endpoints[index];
+        }
+
+        static std::vector<std::string> other_endpoints(std::vector<std::string> endpoints, uint32_t index) {
+            if(index < endpoints.size()) { endpoints.erase(endpoints.begin() + index); }
+            return endpoints;
+        }
+
+        /**
+         * Peer index, in \member channel, of the process with a given endpoint index.
+         */
+        uint32_t peer_of(uint32_t process) const {
+            assert(process != own_index);
+            return (process < own_index) ? process : process - 1u;
+        }
+
+        /**
+         * Whether processes exchange migrants at all.
+         */
+        bool migrating() const { return num_processes > 1u && params.migration_freq_generations > 0u; }
+
+        /**
+         * Sends the best individuals to the other processes, and lets the individuals
+         * received from them enter the population.
+         */
+        void migrate() const {
+            auto frames = std::vector<uint8_t>();
+            for(const auto& emigrant : island.best_individuals(params.migration_size)) { serialise(emigrant, frames); }
+
+            if(params.migration_topology == MigrationTopology::Ring) {
+                channel.send(peer_of((own_index + 1u) % num_processes), frames);
+            } else {
+                for(auto process = 0u; process < num_processes; process++) {
+                    if(process != own_index) { channel.send(peer_of(process), frames); }
+                }
+            }
+
+            // Discard frames which are malformed, or whose chromosomes do not match ours.
+            auto immigrants = Migrants();
+
+            for(const auto& frame : channel.receive()) {
+                auto immigrant = deserialise<Individual>(frame.data(), frame.size());
+                if(immigrant && immigrant->individual.size() == chromosome_size) { immigrants.push_back(std::move(*immigrant)); }
+            }
+
+            island.immigrate(std::move(immigrants));
+        }
+    };
+}
+
+#endif //RKBGA_PROCESSISLANDSOLVER_H
@@ -0,0 +1,193 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_PROFILING_H
+#define RKBGA_PROFILING_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Compile with -DRKBGA_PROFILING=0 to remove the per-generation instrumentation of the solver
+ * altogether. Otherwise, it is only compiled in for visitors which receive the stats
+ * (see \class GenerationStats).
+ */
+#ifndef RKBGA_PROFILING
+#define RKBGA_PROFILING 1
+#endif
+
+namespace bga {
+    /**
+     * Whether the solver may collect \class GenerationStats.
+     */
+    constexpr bool profiling_enabled = (RKBGA_PROFILING != 0);
+
+    /**
+     * Histogram of latencies with logarithmic buckets: bucket 0 counts latencies below 2ns, and
+     * bucket b > 0 counts latencies in [2^b, 2^(b+1)) ns; the last bucket also counts longer ones.
+     */
+    struct LatencyHistogram {
+        static constexpr uint32_t num_buckets = 32u;
+
+        /**
+         * Number of latencies in each bucket.
+         */
+        std::array<uint64_t, num_buckets> counts{};
+
+        /**
+         * Bucket of a latency.
+         */
+        static uint32_t bucket(uint64_t latency_ns) {
+            auto b = 0u;
+            while(latency_ns > 1u && b + 1u < num_buckets) { latency_ns >>= 1u; ++b; }
+            return b;
+        }
+
+        void add(uint64_t latency_ns) { ++counts[bucket(latency_ns)]; }
+
+        void merge(const LatencyHistogram& other) {
+            for(auto b = 0u; b < num_buckets; b++) { counts[b] += other.counts[b]; }
+        }
+
+        void clear() { counts.fill(0u); }
+
+        /**
+         * Number of latencies recorded.
+         */
+        uint64_t total() const {
+            auto sum = uint64_t{0};
+            for(const auto count : counts) { sum += count; }
+            return sum;
+        }
+
+        /**
+         * Upper bound, in ns, of the bucket containing a given quantile (0 to 1) of the latencies,
+         * or 0 if there are none.
+         */
+        uint64_t quantile_ns(double q) const {
+            const auto n = total();
+            if(n == 0u) { return 0u; }
+
+            const auto rank = static_cast<uint64_t>(q * static_cast<double>(n - 1u));
+            auto seen = uint64_t{0};
+
+            for(auto b = 0u; b < num_buckets; b++) {
+                seen += counts[b];
+                if(seen > rank) { return uint64_t{2} << b; }
+            }
+
+            return uint64_t{2} << (num_buckets - 1u);
+        }
+    };
+
+    /**
+     * Where the time of one generation went, and how many evaluations it took. Times are in seconds,
+     * and measured with std::chrono::steady_clock.
+     */
+    struct GenerationStats {
+        /**
+         * Number of the generation (the initial population is generation 0).
+         */
+        uint64_t generation = 0u;
+
+        /**
+         * Time spent copying the elite into the next generation.
+         */
+        double elite_copy_s = 0.0;
+
+        /**
+         * Time spent creating the mutants.
+         */
+        double mutants_s = 0.0;
+
+        /**
+         * Time spent breeding the offspring.
+         */
+        double crossover_s = 0.0;
+
+        /**
+         * Time spent evaluating the new individuals, including cache lookups. With pipelined
+         * generations, it also includes creating them and copying the elite, which overlap with
+         * the evaluations (see \class Solver, contract 10).
+         */
+        double evaluation_s = 0.0;
+
+        /**
+         * Time spent ranking the population.
+         */
+        double ranking_s = 0.0;
+
+        /**
+         * Time spent improving the elite (see Params::improvement_freq_generations).
+         */
+        double improvement_s = 0.0;
+
+        /**
+         * Number of individuals evaluated.
+         */
+        uint64_t evaluations = 0u;
+
+        /**
+         * Number of individuals whose objective value was found in the cache.
+         */
+        uint64_t cache_hits = 0u;
+
+        /**
+         * Latencies of the single evaluations. With batch evaluation, each individual is given
+         * the average latency of its batch.
+         */
+        LatencyHistogram evaluation_latency;
+
+        /**
+         * Best, mean and worst objective values in the population at the end of the generation.
+         */
+        float best_objvalue = 0.0f;
+        float mean_objvalue = 0.0f;
+        float worst_objvalue = 0.0f;
+
+        /**
+         * Total time of the generation.
+         */
+        double total_s() const { return elite_copy_s + mutants_s + crossover_s + evaluation_s + ranking_s + improvement_s; }
+
+        /**
+         * Evaluations per second of the evaluation phase.
+         */
+        double evaluations_per_s() const { return (evaluation_s > 0.0) ? static_cast<double>(evaluations) / evaluation_s : 0.0; }
+
+        /**
+         * Adds the times and counts of another generation to these ones, and takes its population stats.
+         */
+        void accumulate(const GenerationStats& other) {
+            generation = other.generation;
+            best_objvalue = other.best_objvalue;
+            mean_objvalue = other.mean_objvalue;
+            worst_objvalue = other.worst_objvalue;
+            elite_copy_s += other.elite_copy_s;
+            mutants_s += other.mutants_s;
+            crossover_s += other.crossover_s;
+            evaluation_s += other.evaluation_s;
+            ranking_s += other.ranking_s;
+            improvement_s += other.improvement_s;
+            evaluations += other.evaluations;
+            cache_hits += other.cache_hits;
+            evaluation_latency.merge(other.evaluation_latency);
+        }
+    };
+
+    /**
+     * Clock used to time the phases of a generation.
+     */
+    using ProfilingClock = std::chrono::steady_clock;
+
+    /**
+     * Nanoseconds elapsed since a given time point.
+     */
+    inline uint64_t nanoseconds_since(ProfilingClock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(ProfilingClock::now() - start).count());
+    }
+}
+
+#endif //RKBGA_PROFILING_H
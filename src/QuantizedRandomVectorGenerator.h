@@ -0,0 +1,82 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_QUANTIZEDRANDOMVECTORGENERATOR_H
+#define RKBGA_QUANTIZEDRANDOMVECTORGENERATOR_H
+
+#include <vector>
+#include <cstdint>
+#include "Random.h"
+#include "Xoshiro256pp.h"
+#include "QuantizedRandomVectorIndividual.h"
+
+namespace bga {
+    /**
+     * Generator of \class QuantizedRandomVectorIndividual of a given length, with uniformly
+     * distributed 16-bit keys.
+     * @tparam Engine   The random engine used by \fn generate when no engine is passed.
+     */
+    template<class Engine = Xoshiro256pp>
+    class QuantizedRandomVectorGenerator {
+        /**
+         * Random-key vector length.
+         */
+        const uint32_t length;
+
+        /**
+         * Engine used to generate the new individuals.
+         */
+        mutable Engine engine;
+
+    public:
+        using individual_type = QuantizedRandomVectorIndividual;
+
+        /**
+         * New generator, whose own engine is seeded from the system's random device.
+         * @param length  The length of the generated vectors.
+         */
+        QuantizedRandomVectorGenerator(uint32_t length) : QuantizedRandomVectorGenerator{length, random_seed()} {}
+
+        /**
+         * New generator, with a seeded engine.
+         * @param length  The length of the generated vectors.
+         * @param seed    The seed.
+         */
+        QuantizedRandomVectorGenerator(uint32_t length, uint64_t seed) : length{length}, engine{make_engine<Engine>(seed, 0u)} {}
+
+        /**
+         * Generate a new random individual, with the generator's own engine.
+         */
+        QuantizedRandomVectorIndividual generate() const { return generate(engine); }
+
+        /**
+         * Generate a new random individual, drawing the random numbers from a given generator.
+         * Unlike the overload without parameters, this one can be called concurrently.
+         */
+        template<class Rng>
+        QuantizedRandomVectorIndividual generate(Rng& rng) const {
+          auto chromosome = std::vector<uint16_t>(length);
+          fill_uniform_uint16(rng, chromosome.data(), length);
+          return QuantizedRandomVectorIndividual{std::move(chromosome)};
+        }
+
+        /**
+         * Overwrites an existing individual with a new random one, reusing its storage.
+         */
+        void generate_into(QuantizedRandomVectorIndividual& individual) const { generate_into(individual, engine); }
+
+        /**
+         * Overwrites an existing individual with a new random one, reusing its storage and drawing
+         * the random numbers from a given generator. This can be called concurrently.
+         */
+        template<class Rng>
+        void generate_into(QuantizedRandomVectorIndividual& individual, Rng& rng) const {
+          if(individual.size() != length) { individual = generate(rng); return; }
+
+          fill_uniform_uint16(rng, individual.data(), length);
+        }
+    };
+}
+
+#endif //RKBGA_QUANTIZEDRANDOMVECTORGENERATOR_H
@@ -0,0 +1,162 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_QUANTIZEDRANDOMVECTORINDIVIDUAL_H
+#define RKBGA_QUANTIZEDRANDOMVECTORINDIVIDUAL_H
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include "Hash.h"
+#include "CrossoverKernels.h"
+
+namespace bga {
+    /**
+     * Random-key individual whose keys are quantised to 16-bit integers, i.e. the key k stands
+     * for the real number k / 2^16 in [0,1). Since only the relative order of the keys matters
+     * when decoding, this halves the memory used by each individual, and the memory traffic of
+     * crossover and decoding, with respect to \class RandomVectorIndividual. The price is that,
+     * in long chromosomes, many keys are equal: ties are broken by position, so such keys keep
+     * their relative order in the decoded permutation.
+     */
+    class QuantizedRandomVectorIndividual {
+        /**
+         * The chromosome, made by a vector of quantised random keys.
+         */
+        std::vector<uint16_t> chromosome;
+
+        /**
+         * Chromosomes at least this long are decoded by radix sort, shorter ones by comparison sort.
+         */
+        static constexpr uint32_t radix_sort_min_size = 128u;
+
+    public:
+        /**
+         * Construct from an explicitely given chromosome.
+         * @param chromosome    The quantised random-key chromosome
+         */
+        QuantizedRandomVectorIndividual(std::vector<uint16_t> chromosome) : chromosome{std::move(chromosome)} {}
+
+        /**
+         * Produces a new individual, via biased crossover of this individual with another one.
+         * The crossover is done element-by-element on the elements of the chromosome, so that the child
+         * inherits each element from one of the two parents.
+         * @param other The other parent individual.
+         * @param bias  Probability that the child inherits each element from this individual.
+         * @param rng   A random number generator from which the key of the biased coin tosses
+         *              is drawn (see \file CrossoverKernels.h).
+         * @return      The new child.
+         */
+        template<class Rng>
+        QuantizedRandomVectorIndividual biased_crossover_with(const QuantizedRandomVectorIndividual& other, float bias, Rng& rng) const {
+          auto child = *this;
+          biased_crossover_into(other, bias, rng, child);
+          return child;
+        }
+
+        /**
+         * Same as \fn biased_crossover_with, but writes the new individual over an existing one,
+         * reusing its storage, so that no memory is allocated when the two have the same length.
+         * @param other The other parent individual.
+         * @param bias  Probability of inheriting each element from this individual.
+         * @param rng   A random number generator used to toss the biased coin.
+         * @param child The individual which will be overwritten by the child.
+         */
+        template<class Rng>
+        void biased_crossover_into(const QuantizedRandomVectorIndividual& other, float bias, Rng& rng, QuantizedRandomVectorIndividual& child) const {
+          assert(other.chromosome.size() == chromosome.size());
+          assert(0 <= bias && bias <= 1);
+          assert(&child != this && &child != &other);
+
+          child.chromosome.resize(chromosome.size());
+
+          crossover::biased_crossover(chromosome.data(), other.chromosome.data(), child.chromosome.data(), size(), bias, rng);
+        }
+
+        /**
+         * Writes the permutation encoded by the keys, i.e. the positions of the chromosome sorted by
+         * increasing key, ties broken by position. Long chromosomes are sorted by two stable counting
+         * sort passes, on the low and then on the high byte of the keys, short ones by sorting the keys
+         * packed with their positions.
+         * @param permutation   The output; it is resized to the length of the chromosome.
+         */
+        void decode(std::vector<uint32_t>& permutation) const {
+            const auto n = size();
+            permutation.resize(n);
+
+            if(n < radix_sort_min_size) {
+                thread_local auto packed = std::vector<uint64_t>();
+                packed.resize(n);
+
+                for(auto i = 0u; i < n; i++) { packed[i] = (static_cast<uint64_t>(chromosome[i]) << 32u) | i; }
+                std::sort(packed.begin(), packed.end());
+                for(auto i = 0u; i < n; i++) { permutation[i] = static_cast<uint32_t>(packed[i]); }
+
+                return;
+            }
+
+            // Both histograms are filled in the same pass over the keys.
+            uint32_t low[256] = {};
+            uint32_t high[256] = {};
+
+            for(const auto key : chromosome) {
+                ++low[key & 0xFFu];
+                ++high[key >> 8u];
+            }
+
+            auto low_total = 0u;
+            auto high_total = 0u;
+            for(auto digit = 0u; digit < 256u; digit++) {
+                const auto low_count = low[digit];
+                const auto high_count = high[digit];
+                low[digit] = low_total;
+                high[digit] = high_total;
+                low_total += low_count;
+                high_total += high_count;
+            }
+
+            thread_local auto buffer = std::vector<uint32_t>();
+            buffer.resize(n);
+
+            for(auto i = 0u; i < n; i++) { buffer[low[chromosome[i] & 0xFFu]++] = i; }
+            for(const auto i : buffer) { permutation[high[chromosome[i] >> 8u]++] = i; }
+        }
+
+        /**
+         * Returns the i-th component of the chromosome.
+         */
+        uint16_t component(uint32_t i) const { return chromosome[i]; }
+
+        /**
+         * Sets the i-th component of the chromosome.
+         */
+        void set_component(uint32_t i, uint16_t value) { chromosome[i] = value; }
+
+        /**
+         * Returns a pointer to the keys of the chromosome, e.g. to overwrite them in bulk.
+         */
+        uint16_t* data() { return chromosome.data(); }
+        const uint16_t* data() const { return chromosome.data(); }
+
+        /**
+         * Returns the length of the chromosome.
+         */
+        uint32_t size() const { return static_cast<uint32_t>(chromosome.size()); }
+
+        /**
+         * Returns a hash of the chromosome.
+         */
+        uint64_t hash() const { return hash_words(chromosome.data(), chromosome.size()); }
+    };
+
+    /**
+     * Quantises a random key in [0,1] to 16 bits.
+     */
+    inline uint16_t quantise_key(float key) {
+        return static_cast<uint16_t>(std::min(65535.0f, std::max(0.0f, key * 65536.0f)));
+    }
+}
+
+#endif //RKBGA_QUANTIZEDRANDOMVECTORINDIVIDUAL_H
@@ -0,0 +1,194 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_RANDOM_H
+#define RKBGA_RANDOM_H
+
+#include <random>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#ifndef RKBGA_X86_KERNELS
+#define RKBGA_X86_KERNELS
+#endif
+#include <immintrin.h>
+#endif
+
+namespace bga {
+    /**
+     * Derives a new seed from a seed and a salt (e.g., to give each island its own seed),
+     * with the SplitMix64 finaliser.
+     */
+    inline uint64_t derive_seed(uint64_t seed, uint64_t salt) {
+        auto z = seed + 0x9E3779B97F4A7C15ull * (salt + 1u);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * Draws a 64-bit seed from the system's random device.
+     */
+    inline uint64_t random_seed() {
+        auto source = std::random_device{};
+        const auto high = static_cast<uint64_t>(source());
+        return (high << 32u) | source();
+    }
+
+    /**
+     * Creates a random engine for a given stream of a seed. Engines constructible from a seed and
+     * a stream identifier (such as \class Philox4x32, \class Xoshiro256pp and \class Pcg64) are
+     * constructed directly; the others (such as std::mt19937) are seeded through a std::seed_seq.
+     */
+    template<class Engine>
+    inline Engine make_engine(uint64_t seed, uint64_t stream) {
+        if constexpr(std::is_constructible<Engine, uint64_t, uint64_t>::value) {
+            return Engine{seed, stream};
+        } else {
+            auto seeds = std::seed_seq{
+                static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32u),
+                static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32u)
+            };
+            return Engine{seeds};
+        }
+    }
+
+    /**
+     * Draws an integer uniformly distributed in [0, n), with Lemire's multiply-and-shift method
+     * (which, unlike std::uniform_int_distribution, gives the same result with every standard
+     * library). The bias is at most n / 2^32, i.e. negligible for population sizes.
+     * @param rng   A generator of 32 (or more) random bits.
+     * @param n     The size of the range; must be positive.
+     */
+    template<class Rng>
+    inline uint32_t uniform_index(Rng& rng, uint32_t n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(static_cast<uint32_t>(rng())) * n) >> 32);
+    }
+
+    namespace random {
+        /**
+         * Converts random words to floats in [0,1): the 24 high bits of each word, which a float
+         * represents exactly, are scaled by 2^-24. The vectorised versions give the same floats.
+         */
+        inline void words_to_unit_floats_scalar(const uint32_t* words, float* out, uint32_t size) {
+            for(auto i = 0u; i < size; i++) { out[i] = static_cast<float>(words[i] >> 8u) * (1.0f / 16777216.0f); }
+        }
+
+#ifdef RKBGA_X86_KERNELS
+        __attribute__((target("avx2")))
+        inline void words_to_unit_floats_avx2(const uint32_t* words, float* out, uint32_t size) {
+            const auto scale = _mm256_set1_ps(1.0f / 16777216.0f);
+            auto i = 0u;
+
+            for(; i + 8u <= size; i += 8u) {
+                const auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(w, 8)), scale));
+            }
+
+            words_to_unit_floats_scalar(words + i, out + i, size - i);
+        }
+
+        __attribute__((target("sse2")))
+        inline void words_to_unit_floats_sse2(const uint32_t* words, float* out, uint32_t size) {
+            const auto scale = _mm_set1_ps(1.0f / 16777216.0f);
+            auto i = 0u;
+
+            for(; i + 4u <= size; i += 4u) {
+                const auto w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(w, 8)), scale));
+            }
+
+            words_to_unit_floats_scalar(words + i, out + i, size - i);
+        }
+#endif
+
+        using WordsToFloats = void (*)(const uint32_t*, float*, uint32_t);
+
+        /**
+         * The conversion used on this machine, chosen once according to the CPU's instruction sets.
+         */
+        inline WordsToFloats words_to_unit_floats() {
+            static const auto selected = [] () -> WordsToFloats {
+#ifdef RKBGA_X86_KERNELS
+                __builtin_cpu_init();
+                if(__builtin_cpu_supports("avx2")) { return &words_to_unit_floats_avx2; }
+                if(__builtin_cpu_supports("sse2")) { return &words_to_unit_floats_sse2; }
+#endif
+                return &words_to_unit_floats_scalar;
+            }();
+            return selected;
+        }
+
+        /**
+         * Fills a buffer with random 32-bit words; 64-bit engines give two words per call.
+         */
+        template<class Rng>
+        inline void fill_words(Rng& rng, uint32_t* words, uint32_t size) {
+            using Result = typename Rng::result_type;
+
+            static_assert(Rng::min() == 0u && (Rng::max() == std::numeric_limits<uint32_t>::max() ||
+                                               Rng::max() == std::numeric_limits<uint64_t>::max()),
+                          "The engine must produce 32 or 64 uniformly random bits per call");
+
+            if constexpr(sizeof(Result) >= 8u && Rng::max() == std::numeric_limits<uint64_t>::max()) {
+                auto i = 0u;
+                for(; i + 2u <= size; i += 2u) {
+                    const auto bits = static_cast<uint64_t>(rng());
+                    words[i] = static_cast<uint32_t>(bits);
+                    words[i + 1u] = static_cast<uint32_t>(bits >> 32u);
+                }
+                if(i < size) { words[i] = static_cast<uint32_t>(rng()); }
+            } else {
+                for(auto i = 0u; i < size; i++) { words[i] = static_cast<uint32_t>(rng()); }
+            }
+        }
+    }
+
+    /**
+     * Fills an array with floats uniformly distributed in [0,1), in bulk: random words are drawn
+     * into a small buffer, and converted to floats several at a time with SIMD instructions.
+     * The result only depends on the engine's output, not on the instruction set used.
+     * @param rng   A generator of 32 or 64 random bits per call.
+     * @param out   The array to fill.
+     * @param size  Number of floats.
+     */
+    template<class Rng>
+    void fill_uniform_floats(Rng& rng, float* out, uint32_t size) {
+        constexpr auto buffer_size = 256u;
+        uint32_t words[buffer_size];
+
+        const auto convert = random::words_to_unit_floats();
+
+        for(auto begin = 0u; begin < size; begin += buffer_size) {
+            const auto count = std::min(buffer_size, size - begin);
+            random::fill_words(rng, words, count);
+            convert(words, out + begin, count);
+        }
+    }
+
+    /**
+     * Fills an array with 16-bit integers uniformly distributed in [0, 2^16), in bulk: each
+     * random word gives two of them.
+     * @param rng   A generator of 32 or 64 random bits per call.
+     * @param out   The array to fill.
+     * @param size  Number of integers.
+     */
+    template<class Rng>
+    void fill_uniform_uint16(Rng& rng, uint16_t* out, uint32_t size) {
+        constexpr auto buffer_size = 256u;
+        uint32_t words[buffer_size];
+
+        for(auto begin = 0u; begin < size; begin += 2u * buffer_size) {
+            const auto count = std::min(2u * buffer_size, size - begin);
+            random::fill_words(rng, words, (count + 1u) / 2u);
+            std::memcpy(out + begin, words, count * sizeof(uint16_t));
+        }
+    }
+}
+
+#endif //RKBGA_RANDOM_H
@@ -6,8 +6,9 @@
 #define RKBGA_RANDOM_VECTOR_INDIVIDUAL_H
 
 #include <vector>
-#include <random>
 #include <cassert>
+#include "Hash.h"
+#include "CrossoverKernels.h"
 
 namespace bga {
     /**
@@ -20,7 +21,7 @@ namespace bga {
         /**
          * The chromosome, made by a vector of random keys.
          */
-        const std::vector<float> chromosome;
+        std::vector<float> chromosome;
 
     public:
         /**
@@ -28,7 +29,7 @@ namespace bga {
          * @param chromosome    The random-key chromosome
          * @return              The newly built individual.
          */
-        RandomVectorIndividual(std::vector<float> chromosome) : chromosome{chromosome} {}
+        RandomVectorIndividual(std::vector<float> chromosome) : chromosome{std::move(chromosome)} {}
 
         /**
          * Produces a new individual, via biased crossover of this individual with another one.
@@ -39,36 +40,63 @@ namespace bga {
          *              inherit each element of its chromosome from this individual. Therefore,
          *              the child will have a probability of 1-bias of inheriting each element of
          *              its chromosome from the other parent.
-         * @param mt    A Mersenne Twister used to toss the biased coin.
+         * @param rng   A random number generator (e.g., a Mersenne Twister) from which the key of the
+         *              biased coin tosses is drawn (see \file CrossoverKernels.h).
          * @return      The new child.
          */
-        RandomVectorIndividual biased_crossover_with(const RandomVectorIndividual& other, float bias, std::mt19937& mt) const {
+        template<class Rng>
+        RandomVectorIndividual biased_crossover_with(const RandomVectorIndividual& other, float bias, Rng& rng) const {
+          auto child = *this;
+          biased_crossover_into(other, bias, rng, child);
+          return child;
+        }
+
+        /**
+         * Same as \fn biased_crossover_with, but writes the new individual over an existing one,
+         * reusing its storage, so that no memory is allocated when the two have the same length.
+         * @param other The other parent individual.
+         * @param bias  Probability of inheriting each element from this individual.
+         * @param rng   A random number generator used to toss the biased coin.
+         * @param child The individual which will be overwritten by the child.
+         */
+        template<class Rng>
+        void biased_crossover_into(const RandomVectorIndividual& other, float bias, Rng& rng, RandomVectorIndividual& child) const {
           assert(other.chromosome.size() == chromosome.size());
           assert(0 <= bias && bias <= 1);
+          assert(&child != this && &child != &other);
 
-          // Copy the current chromosome into the new one.
-          auto new_chromosome = chromosome;
+          // Make room for the new chromosome (no-op if the child already has the right length).
+          child.chromosome.resize(chromosome.size());
 
-          // Gives uniformly distributed real numbers in [0,1], used for biased crossover.
-          auto dist = std::uniform_real_distribution<float>(0, 1);
-
-          for(auto i = 0u; i < chromosome.size(); i++) {
-              // Toss the coin! :-)
-              float p = dist(mt);
-
-              if(p >= bias) {
-                  // Change the i-th component taking it from the other parent.
-                  new_chromosome[i] = other.chromosome[i];
-              }
-          }
-
-          return RandomVectorIndividual{new_chromosome};
+          // Toss all the coins at once! :-)
+          crossover::biased_crossover(chromosome.data(), other.chromosome.data(), child.chromosome.data(), size(), bias, rng);
         }
 
         /**
          * Returns the i-th component of the chromosome.
          */
         float component(uint32_t i) const { return chromosome[i]; }
+
+        /**
+         * Sets the i-th component of the chromosome.
+         */
+        void set_component(uint32_t i, float value) { chromosome[i] = value; }
+
+        /**
+         * Returns a pointer to the keys of the chromosome, e.g. to overwrite them in bulk.
+         */
+        float* data() { return chromosome.data(); }
+        const float* data() const { return chromosome.data(); }
+
+        /**
+         * Returns the length of the chromosome.
+         */
+        uint32_t size() const { return static_cast<uint32_t>(chromosome.size()); }
+
+        /**
+         * Returns a hash of the chromosome.
+         */
+        uint64_t hash() const { return hash_words(chromosome.data(), chromosome.size()); }
     };
 }
 #endif //RKBGA_RANDOM_VECTOR_INDIVIDUAL_H
@@ -0,0 +1,370 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_SOCKETCHANNEL_H
+#define RKBGA_SOCKETCHANNEL_H
+
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "WireFormat.h"
+
+namespace bga {
+    /**
+     * Non-blocking, frame-oriented communication channel between processes running on the same
+     * machine, over Unix domain sockets or loopback TCP. The channel listens on its own endpoint,
+     * from which it receives frames (see \file WireFormat.h) sent by any number of other processes,
+     * and connects to a list of peer endpoints, to which it sends frames.
+     * No operation ever blocks: frames to send are queued and flushed as far as the kernel accepts
+     * them; frames received are returned once complete. Peers which are not up yet, or which go down,
+     * are (re)connected transparently; frames queued for a peer while it is down are dropped.
+     *
+     * Endpoints are written either as "unix:/path/to/socket" or as "tcp:host:port", where host
+     * is an IPv4 address or "localhost".
+     */
+    class SocketChannel {
+        /**
+         * Peer to which this channel sends frames.
+         */
+        struct Peer {
+            std::string endpoint;
+            int fd;
+            bool connected;
+            std::vector<uint8_t> outbox;
+        };
+
+        /**
+         * Connection accepted from another process, from which this channel receives frames.
+         */
+        struct Connection {
+            int fd;
+            std::vector<uint8_t> inbox;
+        };
+
+        /**
+         * Address of an endpoint, in a form suitable for bind and connect.
+         */
+        struct Address {
+            int family;
+            sockaddr_storage storage;
+            socklen_t length;
+        };
+
+        /**
+         * Maximum number of bytes queued for a peer; further frames are dropped.
+         */
+        static constexpr std::size_t max_outbox_size = 16u << 20u;
+
+        /**
+         * Maximum size of a frame; a connection announcing a larger one is considered corrupt.
+         */
+        static constexpr uint32_t max_frame_size = 256u << 20u;
+
+        /**
+         * Own endpoint.
+         */
+        const std::string endpoint;
+
+        /**
+         * Listening socket.
+         */
+        int listen_fd;
+
+        std::vector<Peer> peers;
+        std::vector<Connection> connections;
+
+    public:
+        /**
+         * Creates the channel and starts listening on its own endpoint.
+         * Throws std::invalid_argument if an endpoint is malformed, and std::system_error if
+         * the channel cannot listen on its endpoint.
+         * @param own_endpoint      Endpoint on which frames are received.
+         * @param peer_endpoints    Endpoints to which frames can be sent.
+         */
+        SocketChannel(std::string own_endpoint, const std::vector<std::string>& peer_endpoints) :
+            endpoint{std::move(own_endpoint)}, listen_fd{-1}
+        {
+            const auto address = parse(endpoint);
+
+            if(address.family == AF_UNIX) { ::unlink(reinterpret_cast<const sockaddr_un&>(address.storage).sun_path); }
+
+            listen_fd = open_socket(address.family);
+
+            if(address.family == AF_INET) {
+                auto reuse = 1;
+                ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            }
+
+            if(::bind(listen_fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 || ::listen(listen_fd, 64) != 0) {
+                const auto error = errno;
+                ::close(listen_fd);
+                throw std::system_error(error, std::generic_category(), "Cannot listen on " + endpoint);
+            }
+
+            for(const auto& peer_endpoint : peer_endpoints) {
+                parse(peer_endpoint);
+                peers.push_back(Peer{peer_endpoint, -1, false, {}});
+            }
+        }
+
+        SocketChannel(const SocketChannel&) = delete;
+        SocketChannel& operator=(const SocketChannel&) = delete;
+
+        /**
+         * Closes all sockets.
+         */
+        ~SocketChannel() {
+            flush();
+
+            for(auto& peer : peers) { if(peer.fd >= 0) { ::close(peer.fd); } }
+            for(auto& connection : connections) { ::close(connection.fd); }
+            ::close(listen_fd);
+
+            const auto address = parse(endpoint);
+            if(address.family == AF_UNIX) { ::unlink(reinterpret_cast<const sockaddr_un&>(address.storage).sun_path); }
+        }
+
+        /**
+         * Number of peers.
+         */
+        uint32_t num_peers() const { return static_cast<uint32_t>(peers.size()); }
+
+        /**
+         * Queues frames for a peer, and sends as much as possible of what is queued for it.
+         * @param peer      Index of the peer, in the order given at construction.
+         * @param frames    One or more complete frames.
+         */
+        void send(uint32_t peer, const std::vector<uint8_t>& frames) {
+            auto& p = peers[peer];
+
+            if(p.outbox.size() + frames.size() <= max_outbox_size) {
+                p.outbox.insert(p.outbox.end(), frames.begin(), frames.end());
+            }
+
+            flush(p);
+        }
+
+        /**
+         * Sends as much as possible of the frames queued for all peers.
+         */
+        void flush() {
+            for(auto& peer : peers) { flush(peer); }
+        }
+
+        /**
+         * Accepts new connections, and reads whatever is available from the open ones.
+         * @return  The frames which have been completely received since the last call.
+         */
+        std::vector<std::vector<uint8_t>> receive() {
+            auto frames = std::vector<std::vector<uint8_t>>();
+
+            // Accept all pending connections.
+            for(auto fd = ::accept(listen_fd, nullptr, nullptr); fd >= 0; fd = ::accept(listen_fd, nullptr, nullptr)) {
+                set_non_blocking(fd);
+                connections.push_back(Connection{fd, {}});
+            }
+
+            for(auto it = connections.begin(); it != connections.end(); ) {
+                if(read_frames(*it, frames)) {
+                    ++it;
+                } else {
+                    ::close(it->fd);
+                    it = connections.erase(it);
+                }
+            }
+
+            return frames;
+        }
+
+    private:
+        /**
+         * Parses an endpoint.
+         */
+        static Address parse(const std::string& endpoint) {
+            auto address = Address{};
+            std::memset(&address.storage, 0, sizeof(address.storage));
+
+            if(endpoint.compare(0, 5, "unix:") == 0) {
+                const auto path = endpoint.substr(5);
+                auto& un = reinterpret_cast<sockaddr_un&>(address.storage);
+
+                if(path.empty() || path.size() >= sizeof(un.sun_path)) { throw std::invalid_argument("Invalid socket path in endpoint " + endpoint); }
+
+                un.sun_family = AF_UNIX;
+                std::memcpy(un.sun_path, path.c_str(), path.size() + 1u);
+                address.family = AF_UNIX;
+                address.length = sizeof(sockaddr_un);
+                return address;
+            }
+
+            if(endpoint.compare(0, 4, "tcp:") == 0) {
+                const auto separator = endpoint.rfind(':');
+                auto host = endpoint.substr(4, separator - 4);
+                const auto port = std::strtoul(endpoint.c_str() + separator + 1, nullptr, 10);
+                auto& in = reinterpret_cast<sockaddr_in&>(address.storage);
+
+                if(host == "localhost") { host = "127.0.0.1"; }
+
+                if(separator <= 4 || port == 0u || port > 0xFFFFu || ::inet_pton(AF_INET, host.c_str(), &in.sin_addr) != 1) {
+                    throw std::invalid_argument("Invalid address in endpoint " + endpoint);
+                }
+
+                in.sin_family = AF_INET;
+                in.sin_port = htons(static_cast<uint16_t>(port));
+                address.family = AF_INET;
+                address.length = sizeof(sockaddr_in);
+                return address;
+            }
+
+            throw std::invalid_argument("Unknown endpoint type: " + endpoint);
+        }
+
+        static void set_non_blocking(int fd) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+
+        /**
+         * Opens a non-blocking socket.
+         */
+        static int open_socket(int family) {
+            const auto fd = ::socket(family, SOCK_STREAM, 0);
+
+            if(fd < 0) { throw std::system_error(errno, std::generic_category(), "Cannot create socket"); }
+
+            set_non_blocking(fd);
+
+            if(family == AF_INET) {
+                auto no_delay = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            }
+
+            return fd;
+        }
+
+        /**
+         * Closes the connection to a peer, dropping what was queued for it.
+         */
+        static void disconnect(Peer& peer) {
+            if(peer.fd >= 0) { ::close(peer.fd); }
+            peer.fd = -1;
+            peer.connected = false;
+            peer.outbox.clear();
+        }
+
+        /**
+         * Starts connecting to a peer, if not yet done, and checks whether the connection is established.
+         */
+        static bool connect(Peer& peer) {
+            if(peer.connected) { return true; }
+
+            if(peer.fd < 0) {
+                const auto address = parse(peer.endpoint);
+                peer.fd = open_socket(address.family);
+
+                if(::connect(peer.fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) == 0) {
+                    peer.connected = true;
+                    return true;
+                }
+
+                if(errno != EINPROGRESS) {
+                    // The peer is not listening (yet), or, on a Unix socket, its backlog is full
+                    // (EAGAIN): try again later.
+                    ::close(peer.fd);
+                    peer.fd = -1;
+                    return false;
+                }
+            }
+
+            // A connection is in progress: check, without waiting, whether it completed.
+            auto pfd = pollfd{peer.fd, POLLOUT, 0};
+            if(::poll(&pfd, 1, 0) <= 0) { return false; }
+
+            auto error = 0;
+            auto length = static_cast<socklen_t>(sizeof(error));
+            ::getsockopt(peer.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+
+            if(error != 0) {
+                ::close(peer.fd);
+                peer.fd = -1;
+                return false;
+            }
+
+            peer.connected = true;
+            return true;
+        }
+
+        /**
+         * Sends as much as possible of the frames queued for a peer.
+         */
+        static void flush(Peer& peer) {
+            if(peer.outbox.empty() || !connect(peer)) { return; }
+
+            auto sent = std::size_t{0};
+            while(sent < peer.outbox.size()) {
+                const auto n = ::send(peer.fd, peer.outbox.data() + sent, peer.outbox.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+                if(n > 0) { sent += static_cast<std::size_t>(n); continue; }
+                if(n < 0 && errno == EINTR) { continue; }
+                if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { break; }
+
+                // The peer went away; whatever was queued for it is lost.
+                disconnect(peer);
+                return;
+            }
+
+            peer.outbox.erase(peer.outbox.begin(), peer.outbox.begin() + static_cast<std::ptrdiff_t>(sent));
+        }
+
+        /**
+         * Reads what is available on a connection, and extracts the complete frames.
+         * @return  Whether the connection is still open and sane.
+         */
+        static bool read_frames(Connection& connection, std::vector<std::vector<uint8_t>>& frames) {
+            auto open = true;
+            uint8_t buffer[64u << 10u];
+
+            while(true) {
+                const auto n = ::recv(connection.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+                if(n > 0) { connection.inbox.insert(connection.inbox.end(), buffer, buffer + n); continue; }
+                if(n < 0 && errno == EINTR) { continue; }
+                if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { break; }
+
+                // Closed by the other side, or failed.
+                open = false;
+                break;
+            }
+
+            auto consumed = std::size_t{0};
+            while(true) {
+                const auto size = frame_size(connection.inbox.data() + consumed, connection.inbox.size() - consumed);
+
+                if(size == 0u) { break; }
+                if(size < wire_header_size || size > max_frame_size) { return false; }
+                if(connection.inbox.size() - consumed < size) { break; }
+
+                frames.emplace_back(connection.inbox.begin() + consumed, connection.inbox.begin() + consumed + size);
+                consumed += size;
+            }
+
+            connection.inbox.erase(connection.inbox.begin(), connection.inbox.begin() + static_cast<std::ptrdiff_t>(consumed));
+
+            return open;
+        }
+    };
+}
+
+#endif //RKBGA_SOCKETCHANNEL_H
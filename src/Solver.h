@@ -5,11 +5,24 @@
 #ifndef RKBGA_SOLVER_H
 #define RKBGA_SOLVER_H
 
-#include <set>
+#include <atomic>
 #include <chrono>
-#include <future>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
 #include <type_traits>
 #include "Params.h"
+#include "Random.h"
+#include "Philox.h"
+#include "ThreadPool.h"
+#include "Checkpoint.h"
+#include "FitnessCache.h"
+#include "Population.h"
+#include "Profiling.h"
+#include "SolverTraits.h"
 #include "DefaultSolverVisitor.h"
 #include "IndividualWithObjValue.h"
 
@@ -20,31 +33,111 @@ namespace bga {
      *                      the population.
      * @tparam Evaluator    The class that evaluates the objective function of an individual.
      * @tparam Visitor      The visitor, that can be used for logging, or showing stats to the user, etc.
+     * @tparam Rng          The random engine used to create new individuals; it must be constructible
+     *                      from a seed and a stream identifier (see \fn make_engine), e.g.
+     *                      \class Philox4x32, \class Xoshiro256pp or \class Pcg64.
      *
      * Contracts:
      *  1)  \tparam Generator must implement the method:
      *      Individual generate() const;
+     *      If it also implements the method:
+     *      Individual generate(Rng&) const;
+     *      or, to reuse the storage of old individuals:
+     *      void generate_into(Individual&, Rng&) const;
+     *      the solver calls it concurrently, with a random stream per individual, so that the
+     *      run is reproducible given Params::seed. Otherwise, if it implements the method:
+     *      void generate_into(Individual&) const;
+     *      the solver uses it to create new individuals in place, one at a time.
      *  2)  \tparam Evaluator must implement the method:
      *      float evaluate(const Individual&) const;
+     *      If it also implements the method:
+     *      void evaluate_batch(Span<const Individual>, Span<float>) const;
+     *      the solver uses it instead, passing chunks of individuals and the spans where
+     *      to write their objective values (the two spans have the same size).
      *  3)  \tparam Generator and \tparam Evaluator must typedef individual_type
      *      which will be used as Individual; this typename must be the same for both
      *      the \tparam Generator and the \tparam Evaluator. Furthermore, Individual
-     *      must implement the method:
-     *      Individual biased_crossover_with(Individual, float, std::mt19937&) const;
+     *      must be copy-assignable and implement the method:
+     *      Individual biased_crossover_with(Individual, float, Rng&) const;
+     *      If Individual also implements the method:
+     *      void biased_crossover_into(const Individual&, float, Rng&, Individual&) const;
+     *      the solver uses it to write the offspring over the storage of old individuals.
      *  4)  \tparam Visitor must implement the methods:
      *      void at_start(const IndividualWithObjValue<Individual>&) const;
      *      void at_iteration(const IndividualWithObjValue<Individual>&, uint32_t, float) const;
      *      void at_end(const IndividualWithObjValue<Individual>&, uint32_t, float) const;
+     *      If it also implements the method:
+     *      void at_cache_stats(const CacheStats&) const;
+     *      and the evaluation cache is enabled, it is called just before at_iteration and at_end.
+     *      If it implements the method:
+     *      void at_generation_stats(const GenerationStats&) const;
+     *      it is called after the initial population is created and after each generation, with
+     *      the time spent in each phase of the generation and the number and latencies of the
+     *      evaluations. These stats are not collected for other visitors, nor when compiling
+     *      with RKBGA_PROFILING=0.
+     *  5)  If Params::cache_size is positive, objective values are cached by a hash key. The key
+     *      is computed by the method of \tparam Evaluator:
+     *      uint64_t hash(const Individual&) const;
+     *      if it exists, which should hash the solution the individual decodes to; otherwise
+     *      by the method of Individual:
+     *      uint64_t hash() const;
+     *      If neither exists, the cache is disabled.
+     *  6)  Random numbers are drawn from streams of \tparam Rng identified by the generation and the
+     *      slot of the individual being created, and seeded by Params::seed: the result of a run does
+     *      not depend on the number of threads, nor on how the work is scheduled among them.
+     *  7)  If \tparam Evaluator also typedefs decoded_type (e.g. the tour an individual decodes to)
+     *      and implements the methods:
+     *      void decode(const Individual&, decoded_type&) const;
+     *      float evaluate_decoded(const decoded_type&) const;
+     *      float evaluate_delta(const Individual&, const Individual&, const decoded_type&, float, Span<const uint32_t>) const;
+     *      uint32_t max_delta_diff() const;
+     *      the solver keeps the decoded state of each elite individual, and evaluates each offspring
+     *      incrementally: evaluate_delta receives the offspring, its elite parent, the decoded state
+     *      and objective value of the latter, and the (sorted) positions in which the two chromosomes
+     *      differ. Offspring which differ from their parent in more than max_delta_diff positions, and
+     *      individuals which are not bred from a parent, are evaluated as usual. When an individual
+     *      enters the elite, it is decoded and its objective value is recomputed by evaluate_decoded,
+     *      so that the rounding errors of delta evaluations never pile up along a lineage.
+     *      Individual must then also implement the methods:
+     *      uint32_t size() const;
+     *      T component(uint32_t) const;
+     *      with T equality-comparable.
+     *  8)  If Params::improvement_freq_generations is positive and \tparam Evaluator implements the method:
+     *      float improve(Individual&, float) const;
+     *      then, every Params::improvement_freq_generations generations, the Params::improvement_size
+     *      best individuals are improved in parallel: the method receives an individual and its objective
+     *      value, and must overwrite the individual with an improved one (e.g. by running a local search
+     *      on the solution it decodes to, and encoding the result back into the chromosome) and return
+     *      its objective value.
+     *  9)  If Params::checkpoint_freq_generations is positive and \class WireCodec is specialised for
+     *      Individual, \fn solve saves the population and the progress of the run to Params::checkpoint_file
+     *      every Params::checkpoint_freq_generations generations, and at the end (see \file Checkpoint.h).
+     *      The file is written by a background thread; if it cannot be written, \fn solve throws
+     *      std::runtime_error at the next checkpoint, or at the end of the run. A solver constructed from a checkpoint resumes
+     *      the run where it was saved, without evaluating any individual. Random streams are identified
+     *      by the generation, so that, with a generator which draws from them (see contract 1) and
+     *      without the evaluation cache, the resumed run is identical to an uninterrupted one.
+     * 10)  If Params::pipelined_generations is set, the phases of a generation are not separated by
+     *      barriers: each thread copies an elite individual, or creates a mutant or an offspring, and
+     *      evaluates it right away, while its chromosome is still in cache (with batch evaluation, it
+     *      does so a chunk of individuals at a time). The only barrier left is the ranking, which
+     *      needs all the objective values. The random streams, and therefore the individuals, are the
+     *      same as without pipelining; only with the evaluation cache may individuals with the same
+     *      objective value be ranked differently. The time taken by the whole pipeline is reported
+     *      as GenerationStats::evaluation_s (except for mutants, if \tparam Generator does not draw
+     *      from the solver's random streams, which are created beforehand).
      */
     template<   class Generator,
                 class Evaluator,
-                class Visitor = DefaultSolverVisitor<typename Generator::individual_type>>
+                class Visitor = DefaultSolverVisitor<typename Generator::individual_type>,
+                class Rng = Philox4x32>
     class Solver {
         static_assert(std::is_same<typename Generator::individual_type, typename Evaluator::individual_type>::value,
             "Generator and Evaluator operate on different kind of individuals");
 
         using Individual = typename Generator::individual_type;
-        using Population = std::multiset<IndividualWithObjValue<Individual>>;
+        using Population = bga::Population<Individual>;
+        using DecodedState = typename traits::decoded_state<Evaluator, Individual>::type;
 
         /**
          * Genetic Algorithm Parameters.
@@ -67,10 +160,16 @@ namespace bga {
         const Visitor& visitor;
 
         /**
-         * Ordered list of individuals with their objective value, i.e. the population.
+         * Ranked individuals with their objective value, i.e. the population.
          */
         mutable Population population;
 
+        /**
+         * Buffer into which the next generation is written; swapped with \member population
+         * at the end of each generation.
+         */
+        mutable Population next_generation;
+
         /**
          * Size of the elite population.
          */
@@ -81,14 +180,155 @@ namespace bga {
          */
         const uint32_t new_individuals_size;
 
+        /**
+         * Worker threads used to evaluate individuals.
+         */
+        mutable ThreadPool pool;
+
+        /**
+         * Number of generations evolved so far; it identifies, together with the slot, the
+         * random stream used to create each individual.
+         */
+        mutable uint64_t generation_count;
+
+        /**
+         * Cache of objective values, or nullptr if it is disabled.
+         */
+        mutable std::unique_ptr<FitnessCache> cache;
+
+        /**
+         * Cache keys of the individuals being evaluated, indexed by slot.
+         */
+        mutable std::vector<uint64_t> cache_keys;
+
+        /**
+         * Whether the individual in each slot was found in the cache.
+         */
+        mutable std::vector<char> cache_hits;
+
+        /**
+         * Decoded state of the individual in each slot of \member population, and whether it is
+         * up to date; it is, at least, for the elite (only with delta evaluation).
+         */
+        mutable std::vector<DecodedState> decoded;
+        mutable std::vector<char> decoded_valid;
+
+        /**
+         * Same as \member decoded and \member decoded_valid, for \member next_generation. While the
+         * next generation is evolved, slot k holds the state of the k-th elite individual of
+         * \member population, which is copied into that slot.
+         */
+        mutable std::vector<DecodedState> next_decoded;
+        mutable std::vector<char> next_decoded_valid;
+
+        /**
+         * Rank, in \member population, of the elite parent of the individual in each slot of
+         * \member next_generation, or \member no_parent if it is to be evaluated from scratch.
+         */
+        mutable std::vector<uint32_t> parent_ranks;
+
+        /**
+         * Positions in which the individual in each slot of \member next_generation differs from its elite parent.
+         */
+        mutable std::vector<std::vector<uint32_t>> diff_positions;
+
+        /**
+         * Stats of the generation being evolved (only with profiling).
+         */
+        mutable GenerationStats stats;
+
+        /**
+         * Latency, in ns, of the evaluation of the individual in each slot (only with profiling).
+         */
+        mutable std::vector<uint64_t> latencies_ns;
+
+        /**
+         * Writes the checkpoints, or nullptr if checkpoints are disabled.
+         */
+        mutable std::unique_ptr<CheckpointWriter> checkpoint_writer;
+
+        /**
+         * Buffer into which checkpoints are serialised.
+         */
+        mutable std::vector<uint8_t> checkpoint_buffer;
+
+        /**
+         * Individuals to place in the next initial population (see \fn seed_population).
+         */
+        mutable std::vector<Individual> seeds;
+
+        /**
+         * Checkpoint from which \fn solve resumes the run, if any.
+         */
+        mutable std::optional<Checkpoint<Individual>> resume_point;
+
+        /**
+         * Value of \member parent_ranks for individuals without a parent.
+         */
+        static constexpr uint32_t no_parent = UINT32_MAX;
+
+        /**
+         * Whether offspring are evaluated incrementally from their elite parent.
+         */
+        static constexpr bool delta_evaluation = traits::has_evaluate_delta<Evaluator, Individual>::value;
+
+        /**
+         * Whether the individuals can be hashed, and therefore cached.
+         */
+        static constexpr bool cacheable = traits::has_evaluator_hash<Evaluator, Individual>::value ||
+                                          traits::has_individual_hash<Individual>::value;
+
+        /**
+         * Whether the phases of each generation are timed, for the visitor.
+         */
+        static constexpr bool profiling = profiling_enabled && traits::has_at_generation_stats<Visitor>::value;
+
+        /**
+         * Whether the population can be saved to checkpoints.
+         */
+        static constexpr bool checkpointable = traits::has_wire_codec<Individual>::value;
+
+        /**
+         * Whether the generator draws from the solver's random streams, and can therefore create
+         * individuals concurrently.
+         */
+        static constexpr bool concurrent_generator = traits::has_generate_into_with_rng<Generator, Individual, Rng>::value ||
+                                                     traits::has_generate_with_rng<Generator, Rng>::value;
+
+        /**
+         * Whether individuals are evaluated in batches (with delta evaluation, only those without a parent).
+         */
+        static constexpr bool batch_evaluation = traits::has_evaluate_batch<Evaluator, Individual>::value;
+
     public:
         /**
          * Initialise the algorithm solver.
          */
         Solver(const Params& params, const Generator& generator, const Evaluator& evaluator, const Visitor& visitor) :
-            params{params}, generator{generator}, evaluator{evaluator}, visitor{visitor}, population{Population()},
+            params{params}, generator{generator}, evaluator{evaluator}, visitor{visitor}, population{}, next_generation{},
             elite_size{static_cast<uint32_t>(params.population_size * params.elite_share)},
-            new_individuals_size{static_cast<uint32_t>(params.population_size * params.replace_share)} {}
+            new_individuals_size{static_cast<uint32_t>(params.population_size * params.replace_share)},
+            pool{params.num_threads}, generation_count{0u},
+            cache{(cacheable && params.cache_size > 0) ? std::make_unique<FitnessCache>(params.cache_size) : nullptr},
+            cache_keys(cache ? params.population_size : 0u), cache_hits(cache ? params.population_size : 0u),
+            decoded(delta_evaluation ? params.population_size : 0u), decoded_valid(delta_evaluation ? params.population_size : 0u, 0),
+            next_decoded(delta_evaluation ? params.population_size : 0u), next_decoded_valid(delta_evaluation ? params.population_size : 0u, 0),
+            parent_ranks(delta_evaluation ? params.population_size : 0u, no_parent),
+            diff_positions(delta_evaluation ? params.population_size : 0u), stats{},
+            latencies_ns(profiling ? params.population_size : 0u),
+            checkpoint_writer{(checkpointable && params.checkpoint_freq_generations > 0u && !params.checkpoint_file.empty()) ?
+                              std::make_unique<CheckpointWriter>(params.checkpoint_file) : nullptr} {}
+
+        /**
+         * Initialise the algorithm solver, so that \fn solve resumes a run from a checkpoint.
+         * @param checkpoint    The checkpoint (see \fn read_checkpoint); it must have been written
+         *                      with the same parameters.
+         */
+        Solver(const Params& params, const Generator& generator, const Evaluator& evaluator, const Visitor& visitor, Checkpoint<Individual> checkpoint) :
+            Solver{params, generator, evaluator, visitor}
+        {
+            resume_point = std::move(checkpoint);
+        }
 
         /**
          * Runs the Genetic Algorithm.
@@ -97,155 +337,866 @@ namespace bga {
         IndividualWithObjValue<Individual> solve() const {
             uint32_t generation = 0;
             uint32_t generations_no_improv = 0;
+            float previous_time_s = 0.0f;
 
             auto start_time = std::chrono::steady_clock::now();
 
-            // Generate the initial population.
-            add_new_individuals(population, params.population_size);
-            assert(population.size() == params.population_size);
+            // Generate the initial population, or restore the one of the run being resumed.
+            if(resume_point) {
+                generation = resume_point->state.generation;
+                generations_no_improv = resume_point->state.generations_no_improvement;
+                previous_time_s = resume_point->state.elapsed_time_s;
+                initialise_from(*resume_point);
+                resume_point.reset();
+            } else {
+                initialise();
+            }
 
             // Call the visitor's start action, pass the best individual.
-            visitor.at_start(*population.begin());
+            report_generation_stats();
+            visitor.at_start(population.best());
 
             while(generation < params.max_generations && generations_no_improv < params.max_generations_no_improvement) {
                 auto current_time = std::chrono::steady_clock::now();
-                auto elapsed_time_s = std::chrono::duration<float>(current_time - start_time).count();
+                auto elapsed_time_s = previous_time_s + std::chrono::duration<float>(current_time - start_time).count();
 
                 // Check for timeout.
                 if(elapsed_time_s > params.timeout_s) { break; }
 
-                // Evolve!
-                auto new_generation = evolve_new_generation();
-                assert(new_generation.size() == params.population_size);
-
-                // Check whether there has been a (strict) improvement.
-                if(new_generation.begin()->objvalue < population.begin()->objvalue) { generations_no_improv = 0; }
+                // Evolve, and check whether there has been a (strict) improvement.
+                if(evolve()) { generations_no_improv = 0; }
                 else { ++generations_no_improv; }
 
-                // Replace the old population with the new generation.
-                population = new_generation;
+                report_generation_stats();
 
                 // Call the visitor, if requested.
-                if(generation > 0 && generation % params.visitor_freq_iterations == 0) { visitor.at_iteration(*population.begin(), generation, elapsed_time_s); }
+                if(params.visitor_freq_iterations > 0u && generation > 0 && generation % params.visitor_freq_iterations == 0) {
+                    report_cache_stats();
+                    visitor.at_iteration(population.best(), generation, elapsed_time_s);
+                }
 
                 ++generation;
+
+                if(checkpoint_writer && generation % params.checkpoint_freq_generations == 0) {
+                    save_checkpoint(generation, generations_no_improv, previous_time_s + std::chrono::duration<float>(std::chrono::steady_clock::now() - start_time).count());
+                }
             }
 
             auto end_time = std::chrono::steady_clock::now();
-            auto total_time_s = std::chrono::duration<float>(end_time - start_time).count();
+            auto total_time_s = previous_time_s + std::chrono::duration<float>(end_time - start_time).count();
+
+            if(checkpoint_writer) {
+                save_checkpoint(generation, generations_no_improv, total_time_s);
+                checkpoint_writer->wait();
+                check_checkpoint_writes();
+            }
 
             // Call the visitor's end action, pass the best individual.
-            visitor.at_end(*population.begin(), generation, total_time_s);
+            report_cache_stats();
+            visitor.at_end(population.best(), generation, total_time_s);
 
             // Return the best individual.
-            return *population.begin();
+            return population.best();
         }
 
-    private:
         /**
-         * Adds newly created individuals to a population.
+         * Sets individuals (e.g. the best ones of an earlier run, or solutions built by a heuristic) to be
+         * placed in the initial population by the next call to \fn solve or \fn initialise, instead of as
+         * many random ones. They are evaluated in parallel, together with the rest of the initial population.
+         * @param individuals   The individuals; if there are more than Params::population_size, only
+         *                      the first ones are used.
          */
-        void add_new_individuals(Population& population, uint32_t how_many) const {
+        void seed_population(std::vector<Individual> individuals) const {
+            seeds = std::move(individuals);
+        }
+
+        /**
+         * Same as the other overload, but with solutions which are encoded into individuals.
+         * @param solutions The solutions (e.g. tours).
+         * @param encode    Function encoding a solution into an individual, e.g. \class RandomKeyEncoder
+         *                  or \class TranspositionEncoder for permutations.
+         */
+        template<class Solution, class Encoder>
+        void seed_population(const std::vector<Solution>& solutions, const Encoder& encode) const {
             auto individuals = std::vector<Individual>();
-            auto evaluations = std::vector<std::future<float>>(how_many);
+            individuals.reserve(std::min(static_cast<uint32_t>(solutions.size()), params.population_size));
+
+            for(auto k = 0u; k < solutions.size() && k < params.population_size; k++) { individuals.push_back(encode(solutions[k])); }
+
+            seed_population(std::move(individuals));
+        }
+
+        /*
+         * The following methods let other classes (e.g. \class IslandSolver) drive the algorithm
+         * one generation at a time, instead of calling \fn solve. They do not call the visitor.
+         */
+
+        /**
+         * Creates and evaluates the initial population.
+         */
+        void initialise() const {
+            initialise_population();
+            assert(population.size() == params.population_size);
+        }
+
+        /**
+         * Restores the population saved in a checkpoint, without evaluating it.
+         * @param checkpoint    The checkpoint; it must have been written with the same population
+         *                      size and seed, otherwise std::invalid_argument is thrown.
+         */
+        void initialise_from(const Checkpoint<Individual>& checkpoint) const {
+            if(checkpoint.population.size() != params.population_size) { throw std::invalid_argument("The checkpoint holds a population of a different size"); }
+            if(checkpoint.state.seed != params.seed) { throw std::invalid_argument("The checkpoint was written with a different seed"); }
+
+            generation_count = checkpoint.state.generation_count;
+            if constexpr(profiling) { stats = GenerationStats{}; stats.generation = generation_count; }
+
+            population = Population{};
+            population.reserve(params.population_size);
+
+            // Individuals were saved in the order of their slots, so the ranking is restored as it was.
+            for(const auto& saved : checkpoint.population) { population.add(saved.individual, saved.objvalue); }
+            rank(population);
+
+            std::fill(parent_ranks.begin(), parent_ranks.end(), no_parent);
+            std::fill(decoded_valid.begin(), decoded_valid.end(), 0);
+            anchor_elite(population, decoded, decoded_valid);
+
+            record_population_stats(population);
+
+            next_generation = population;
+            next_decoded = decoded;
+            next_decoded_valid = decoded_valid;
+        }
+
+        /**
+         * Replaces the population with the next generation.
+         * @return  Whether the best objective value has (strictly) improved.
+         */
+        bool evolve() const {
+            evolve_new_generation();
+            assert(next_generation.size() == params.population_size);
+
+            const auto improved = next_generation.ranked_objvalue(0) < population.ranked_objvalue(0);
+
+            // Replace the old population with the new generation: the old one's
+            // storage will be overwritten by the next generation.
+            std::swap(population, next_generation);
+            std::swap(decoded, next_decoded);
+            std::swap(decoded_valid, next_decoded_valid);
+
+            return improved;
+        }
+
+        /**
+         * Returns the best individual in the current population.
+         */
+        IndividualWithObjValue<Individual> best() const { return population.best(); }
+
+        /**
+         * Returns copies of the best individuals in the current population, best first.
+         * @param how_many  Number of individuals; no more than the size of the elite are returned.
+         */
+        std::vector<IndividualWithObjValue<Individual>> best_individuals(uint32_t how_many) const {
+            how_many = std::min(how_many, elite_size);
+
+            auto individuals = std::vector<IndividualWithObjValue<Individual>>();
             individuals.reserve(how_many);
 
-            auto starting_size = population.size();
+            for(auto k = 0u; k < how_many; k++) {
+                individuals.emplace_back(population.ranked_individual(k), population.ranked_objvalue(k));
+            }
+
+            return individuals;
+        }
+
+        /**
+         * Replaces the worst individuals of the current population with the given ones, whose
+         * objective values are taken as they are, without evaluating them again.
+         * @param migrants  The new individuals. If there are more of them than non-elite individuals,
+         *                  only the best ones enter the population.
+         */
+        void immigrate(std::vector<IndividualWithObjValue<Individual>> migrants) const {
+            const auto how_many = std::min(static_cast<uint32_t>(migrants.size()), params.population_size - elite_size);
+
+            if(how_many == 0u) { return; }
 
-            // Launch generators and evaluators (asynchronously).
-            for(auto i = 0u; i < how_many; i++) {
-                individuals.push_back(generator.generate());
+            if(how_many < migrants.size()) {
+                std::partial_sort(migrants.begin(), migrants.begin() + how_many, migrants.end());
             }
 
-            for(auto i = 0u; i < how_many; i++) {
-                evaluations[i] = std::async(std::launch::async, [i,this,&individuals] () -> float { return evaluator.evaluate(individuals[i]); });
+            // Separate the worst individuals from the rest, and overwrite them.
+            population.rank(elite_size, params.population_size - how_many);
+
+            for(auto k = 0u; k < how_many; k++) {
+                const auto slot = population.ranked_slot(params.population_size - 1u - k);
+                population.individual(slot) = std::move(migrants[k].individual);
+                population.set_objvalue(slot, migrants[k].objvalue);
+
+                if constexpr(delta_evaluation) { decoded_valid[slot] = 0; }
             }
 
-            // Get the futures from evaluation.
-            for(auto i = 0u; i < how_many; i++) {
-                population.insert(IndividualWithObjValue<Individual>(individuals[i], evaluations[i].get()));
+            rank(population);
+            anchor_elite(population, decoded, decoded_valid);
+        }
+
+    private:
+        /**
+         * Ranks a full population: sorts the elite, and separates the worst individuals,
+         * which are not picked as parents for crossover, from the others.
+         */
+        void rank(Population& population) const {
+            population.rank(elite_size, params.population_size - new_individuals_size);
+        }
+
+        /**
+         * Random stream used to create the individual in a given slot of the current generation.
+         */
+        Rng random_stream(uint32_t slot) const {
+            return make_engine<Rng>(params.seed, (generation_count << 32u) | slot);
+        }
+
+        /**
+         * Passes the cache counters to the visitor, if both support it.
+         */
+        void report_cache_stats() const {
+            if constexpr(traits::has_at_cache_stats<Visitor>::value) {
+                if(cache) { visitor.at_cache_stats(cache->stats()); }
             }
+        }
 
-            assert(population.size() - starting_size == how_many);
+        /**
+         * Serialises the current population and hands it to the background writer, unless an
+         * earlier checkpoint could not be written (see \fn check_checkpoint_writes).
+         */
+        void save_checkpoint(uint32_t generation, uint32_t generations_no_improv, float elapsed_time_s) const {
+            if constexpr(checkpointable) {
+                check_checkpoint_writes();
+
+                const auto state = CheckpointState{params.seed, generation_count, generation, generations_no_improv, elapsed_time_s};
+                serialise_checkpoint(state, population, checkpoint_buffer);
+                checkpoint_writer->submit(checkpoint_buffer);
+            }
         }
 
         /**
-         * Fills up the population via cross-over.
+         * Throws std::runtime_error if the background writer failed to write a checkpoint, so that
+         * a run which could not be resumed does not go on as if it could.
          */
-        void do_crossover(Population& new_generation) const {
-            assert(population.size() == params.population_size);
+        void check_checkpoint_writes() const {
+            if(checkpoint_writer && checkpoint_writer->failed_writes() > 0u) {
+                throw std::runtime_error("Could not write the checkpoint file " + params.checkpoint_file);
+            }
+        }
 
-            // The number of individuals we have to add is the total population size,
-            // minus the number of elite (which we copied from the previous generation)
-            // and of new individuals (which we created from scratch).
-            auto non_elite_size = params.population_size - elite_size - new_individuals_size;
+        /**
+         * Passes the stats of the last generation to the visitor, if it supports it.
+         */
+        void report_generation_stats() const {
+            if constexpr(profiling) { visitor.at_generation_stats(stats); }
+        }
 
-            // Random number generation.
-            std::mt19937::result_type random_data[std::mt19937::state_size];
-            std::random_device source;
-            std::generate(std::begin(random_data), std::end(random_data), std::ref(source));
-            std::seed_seq seeds(std::begin(random_data), std::end(random_data));
-            auto mt = std::mt19937(seeds);
-            auto elite_rnd = std::uniform_int_distribution<uint32_t>(0, elite_size - 1);
-            auto non_elite_rnd = std::uniform_int_distribution<uint32_t>(0, non_elite_size - 1);
+        /**
+         * Calls a function and, with profiling, adds the time it took to a phase of \member stats.
+         */
+        template<class Fn>
+        void timed(double GenerationStats::* phase_s, const Fn& fn) const {
+            if constexpr(profiling) {
+                const auto start = ProfilingClock::now();
+                fn();
+                stats.*phase_s += 1e-9 * static_cast<double>(nanoseconds_since(start));
+            } else {
+                fn();
+            }
+        }
 
-            auto individuals = std::vector<Individual>();
-            auto evaluations = std::vector<std::future<float>>(non_elite_size);
-            individuals.reserve(non_elite_size);
+        /**
+         * With profiling, records the best, mean and worst objective values of a ranked population.
+         */
+        void record_population_stats(const Population& population) const {
+            if constexpr(profiling) {
+                auto sum = 0.0;
+                auto worst = population.ranked_objvalue(0);
 
-            // Do crossover and get evaluations asyncronously.
-            for(auto i = 0u; i < non_elite_size; i++) {
-                auto elite_it = population.begin(), non_elite_it = population.begin();
+                for(auto slot = 0u; slot < population.size(); slot++) {
+                    sum += population.objvalue(slot);
+                    worst = std::max(worst, population.objvalue(slot));
+                }
 
-                // Pick a random elite individual.
-                std::advance(elite_it, elite_rnd(mt));
+                stats.best_objvalue = population.ranked_objvalue(0);
+                stats.mean_objvalue = static_cast<float>(sum / population.size());
+                stats.worst_objvalue = worst;
+            }
+        }
 
-                // Pick a random non-elite (and non-new) individual.
-                std::advance(non_elite_it, elite_size + non_elite_rnd(mt));
+        /**
+         * Calls a function which evaluates the individual in a given slot and, with profiling,
+         * records how long it took.
+         */
+        template<class Fn>
+        void timed_evaluation(uint32_t slot, const Fn& fn) const {
+            if constexpr(profiling) {
+                const auto start = ProfilingClock::now();
+                fn();
+                latencies_ns[slot] = nanoseconds_since(start);
+            } else {
+                fn();
+            }
+        }
+
+        /**
+         * Cache key of an individual: the hash of the solution it decodes to, if the evaluator
+         * provides it, otherwise the hash of its chromosome.
+         */
+        uint64_t cache_key(const Individual& individual) const {
+            if constexpr(traits::has_evaluator_hash<Evaluator, Individual>::value) {
+                return evaluator.hash(individual);
+            } else {
+                return individual.hash();
+            }
+        }
+
+        /**
+         * Exchanges the contents of two slots of a population which are being evaluated, together
+         * with the information needed to evaluate them incrementally, if any. Their decoded states
+         * are not up to date, and need not follow them.
+         */
+        void swap_slots(Population& population, uint32_t slot1, uint32_t slot2) const {
+            population.swap_slots(slot1, slot2);
+
+            if constexpr(delta_evaluation) {
+                std::swap(parent_ranks[slot1], parent_ranks[slot2]);
+                std::swap(diff_positions[slot1], diff_positions[slot2]);
+            }
+        }
+
+        /**
+         * Evaluates the individuals in slots [begin, end) of a population, skipping those which
+         * are found in the cache. The slots of the individuals which are evaluated are moved to the
+         * front of the range, which is fine since the range is ranked afterwards anyway.
+         */
+        void evaluate(Population& population, uint32_t begin, uint32_t end) const {
+            if constexpr(cacheable) {
+                if(cache) {
+                    // Look up all individuals.
+                    pool.parallel_for(begin, end, [this,&population] (uint32_t slot) {
+                        auto objvalue = 0.0f;
+                        cache_keys[slot] = cache_key(population.individual(slot));
+                        cache_hits[slot] = cache->lookup(cache_keys[slot], objvalue);
+                        if(cache_hits[slot]) { population.set_objvalue(slot, objvalue); }
+                    });
+
+                    // Move the individuals which were not found to the front of the range.
+                    auto misses_end = begin;
+                    for(auto slot = begin; slot < end; slot++) {
+                        if(cache_hits[slot]) { continue; }
+                        if(slot != misses_end) {
+                            swap_slots(population, slot, misses_end);
+                            std::swap(cache_keys[slot], cache_keys[misses_end]);
+                        }
+                        ++misses_end;
+                    }
+
+                    if constexpr(profiling) { stats.cache_hits += end - misses_end; }
+
+                    evaluate_all(population, begin, misses_end);
+
+                    for(auto slot = begin; slot < misses_end; slot++) {
+                        cache->insert(cache_keys[slot], population.objvalue(slot));
+                    }
+
+                    return;
+                }
+            }
+
+            evaluate_all(population, begin, end);
+        }
+
+        /**
+         * Evaluates, in parallel on the thread pool, the individuals in slots [begin, end) of a population.
+         * With delta evaluation, offspring are evaluated incrementally from their elite parent in
+         * \member population.
+         */
+        void evaluate_all(Population& population, uint32_t begin, uint32_t end) const {
+            if constexpr(batch_evaluation) {
+                pool.parallel_for_chunks(begin, end, [this,&population] (uint32_t chunk_begin, uint32_t chunk_end) {
+                    evaluate_chunk(population, chunk_begin, chunk_end);
+                });
+            } else {
+                pool.parallel_for(begin, end, [this,&population] (uint32_t slot) {
+                    evaluate_one(population, slot);
+                });
+            }
+
+            if constexpr(profiling) {
+                stats.evaluations += end - begin;
+                for(auto slot = begin; slot < end; slot++) { stats.evaluation_latency.add(latencies_ns[slot]); }
+            }
+        }
+
+        /**
+         * Evaluates the individual in a given slot of a population; with delta evaluation, offspring
+         * are evaluated incrementally from their elite parent in \member population, whose decoded
+         * state is in \member next_decoded.
+         */
+        void evaluate_one(Population& population, uint32_t slot) const {
+            timed_evaluation(slot, [this,&population,slot] () {
+                const auto& individual = population.individual(slot);
+
+                if constexpr(delta_evaluation) {
+                    const auto parent = parent_ranks[slot];
+
+                    if(parent != no_parent) {
+                        const auto& diff = diff_positions[slot];
+                        population.set_objvalue(slot, evaluator.evaluate_delta(individual, this->population.ranked_individual(parent), next_decoded[parent],
+                                                                               this->population.ranked_objvalue(parent), Span<const uint32_t>{diff.data(), diff.size()}));
+                        return;
+                    }
+                }
+
+                population.set_objvalue(slot, evaluator.evaluate(individual));
+            });
+        }
 
-                // Do biased crossover of the elite and non-elite individuals.
-                individuals.push_back(elite_it->individual.biased_crossover_with(non_elite_it->individual, params.crossover_elite_bias, mt));
+        /**
+         * Evaluates the individuals in slots [begin, end) of a population, in batches; with delta
+         * evaluation, only the runs of individuals without a parent are, and offspring are evaluated
+         * incrementally one by one. Slots are not moved, so the result does not depend on the chunks.
+         */
+        void evaluate_chunk(Population& population, uint32_t begin, uint32_t end) const {
+            if constexpr(delta_evaluation) {
+                for(auto slot = begin; slot < end; ) {
+                    auto run_end = slot;
+                    while(run_end < end && parent_ranks[run_end] == no_parent) { ++run_end; }
+
+                    evaluate_batch(population, slot, run_end);
+
+                    for(slot = run_end; slot < end && parent_ranks[slot] != no_parent; slot++) { evaluate_one(population, slot); }
+                }
+            } else {
+                evaluate_batch(population, begin, end);
+            }
+        }
+
+        /**
+         * Evaluates the individuals in slots [begin, end) of a population with one call to the
+         * evaluator's batch method.
+         */
+        void evaluate_batch(Population& population, uint32_t begin, uint32_t end) const {
+            if constexpr(batch_evaluation) {
+                if(begin == end) { return; }
+
+                timed_evaluation(begin, [this,&population,begin,end] () {
+                    evaluator.evaluate_batch(population.individuals_in(begin, end), population.objvalues_in(begin, end));
+                });
+
+                // Each individual of the batch gets the average latency.
+                if constexpr(profiling) {
+                    std::fill(latencies_ns.begin() + begin, latencies_ns.begin() + end, latencies_ns[begin] / (end - begin));
+                }
             }
+        }
+
+        /**
+         * Improves the best individuals of a ranked population in parallel, with the evaluator's
+         * local search (if any), and ranks the population again.
+         * @param states    Decoded states of the population's individuals (only with delta evaluation).
+         * @param valid     Which of them are up to date.
+         */
+        void improve_elite(Population& population, std::vector<DecodedState>& states, std::vector<char>& valid) const {
+            if constexpr(traits::has_improve<Evaluator, Individual>::value) {
+                const auto how_many = std::min(params.improvement_size, params.population_size);
 
-            for(auto i = 0u; i < non_elite_size; i++) {
-                // Launch evaluation.
-                evaluations[i] = std::async(std::launch::async, [i,this,&individuals] () -> float { return evaluator.evaluate(individuals[i]); });
+                pool.parallel_for(0u, how_many, [this,&population,&states,&valid] (uint32_t k) {
+                    const auto slot = population.ranked_slot(k);
+                    population.set_objvalue(slot, evaluator.improve(population.individual(slot), population.objvalue(slot)));
+
+                    if constexpr(delta_evaluation) {
+                        evaluator.decode(population.individual(slot), states[slot]);
+                        valid[slot] = 1;
+                    }
+                });
+
+                rank(population);
+                anchor_elite(population, states, valid);
             }
+        }
+
+        /**
+         * With delta evaluation, decodes the elite individuals of a ranked population whose state is
+         * not up to date, and recomputes their objective values from scratch, so that errors of the
+         * incremental evaluation do not build up along lineages. If any objective value changes, the
+         * population is ranked again, until the whole elite is up to date.
+         * @param states    Decoded states of the population's individuals.
+         * @param valid     Which of them are up to date.
+         */
+        void anchor_elite(Population& population, std::vector<DecodedState>& states, std::vector<char>& valid) const {
+            if constexpr(delta_evaluation) {
+                auto changed = std::atomic<bool>{true};
+
+                while(changed) {
+                    changed = false;
+
+                    pool.parallel_for(0u, elite_size, [this,&population,&states,&valid,&changed] (uint32_t k) {
+                        const auto slot = population.ranked_slot(k);
+                        if(valid[slot]) { return; }
 
-            assert(individuals.size() == evaluations.size());
-            assert(new_generation.size() + individuals.size() == params.population_size);
+                        evaluator.decode(population.individual(slot), states[slot]);
+                        valid[slot] = 1;
 
-            // Get futures.
-            for(auto i = 0u; i < non_elite_size; i++) {
-                new_generation.insert(IndividualWithObjValue<Individual>(individuals[i], evaluations[i].get()));
+                        const auto objvalue = evaluator.evaluate_decoded(states[slot]);
+                        if(objvalue != population.objvalue(slot)) {
+                            population.set_objvalue(slot, objvalue);
+                            changed = true;
+                        }
+                    });
+
+                    if(changed) { rank(population); }
+                }
             }
+        }
 
-            assert(new_generation.size() == params.population_size);
+        /**
+         * With delta evaluation, moves the decoded states of the elite of the current population to
+         * \member next_decoded, in the order of their ranks: this is where the elite is copied in the
+         * new generation, and where its offspring find the state of their parent.
+         */
+        void take_elite_states() const {
+            if constexpr(delta_evaluation) {
+                for(auto k = 0u; k < params.population_size; k++) {
+                    if(k < elite_size) {
+                        std::swap(next_decoded[k], decoded[population.ranked_slot(k)]);
+                        next_decoded_valid[k] = 1;
+                    } else {
+                        next_decoded_valid[k] = 0;
+                    }
+                }
+            }
         }
 
         /**
-         * Evolves the next generation of individuals.
+         * Creates, evaluates and ranks the initial population, and allocates the buffer
+         * for the next generations.
          */
-        Population evolve_new_generation() const {
+        void initialise_population() const {
+            generation_count = 0u;
+            if constexpr(profiling) { stats = GenerationStats{}; }
+
+            population = Population{};
+            population.reserve(params.population_size);
+
+            // Seeds go first, and random individuals fill the remaining slots.
+            const auto num_seeds = std::min(static_cast<uint32_t>(seeds.size()), params.population_size);
+            for(auto slot = 0u; slot < num_seeds; slot++) { population.add(std::move(seeds[slot]), 0.0f); }
+            seeds.clear();
+
+            timed(&GenerationStats::mutants_s, [this,num_seeds] () {
+                if constexpr(traits::has_generate_with_rng<Generator, Rng>::value) {
+                    // Each slot has its own random stream, so the individuals are created in parallel.
+                    auto randoms = std::vector<std::optional<Individual>>(params.population_size - num_seeds);
+                    pool.parallel_for(num_seeds, params.population_size, [this,num_seeds,&randoms] (uint32_t slot) {
+                        auto rng = random_stream(slot);
+                        randoms[slot - num_seeds].emplace(generator.generate(rng));
+                    });
+
+                    for(auto& individual : randoms) { population.add(std::move(*individual), 0.0f); }
+                } else {
+                    for(auto slot = num_seeds; slot < params.population_size; slot++) { population.add(generator.generate(), 0.0f); }
+
+                    // The generator's own individuals only provide the storage, which is overwritten from each slot's random stream.
+                    if constexpr(concurrent_generator) {
+                        pool.parallel_for(num_seeds, params.population_size, [this] (uint32_t slot) { generate_new_individual(population, slot); });
+                    }
+                }
+            });
+
+            std::fill(parent_ranks.begin(), parent_ranks.end(), no_parent);
+
+            timed(&GenerationStats::evaluation_s, [this] () { evaluate(population, 0u, params.population_size); });
+            timed(&GenerationStats::ranking_s, [this] () {
+                rank(population);
+
+                std::fill(decoded_valid.begin(), decoded_valid.end(), 0);
+                anchor_elite(population, decoded, decoded_valid);
+            });
+            record_population_stats(population);
+
+            // This is the only time the chromosomes of the next generation are allocated.
+            next_generation = population;
+            next_decoded = decoded;
+            next_decoded_valid = decoded_valid;
+        }
+
+        /**
+         * Overwrites the individuals in slots [begin, end) of the new generation with new random individuals.
+         */
+        void generate_new_individuals(uint32_t begin, uint32_t end) const {
+            if constexpr(concurrent_generator) {
+                pool.parallel_for(begin, end, [this] (uint32_t slot) { generate_new_individual(next_generation, slot); });
+            } else {
+                // The generator uses its own engine, which cannot be shared among threads.
+                for(auto slot = begin; slot < end; slot++) {
+                    if constexpr(traits::has_generate_into<Generator, Individual>::value) {
+                        generator.generate_into(next_generation.individual(slot));
+                    } else {
+                        next_generation.individual(slot) = generator.generate();
+                    }
+                }
+            }
+        }
+
+        /**
+         * Overwrites the individual in a given slot of a population with a new random individual,
+         * drawn from the slot's random stream.
+         */
+        void generate_new_individual(Population& population, uint32_t slot) const {
+            if constexpr(traits::has_generate_into_with_rng<Generator, Individual, Rng>::value) {
+                auto rng = random_stream(slot);
+                generator.generate_into(population.individual(slot), rng);
+            } else if constexpr(traits::has_generate_with_rng<Generator, Rng>::value) {
+                auto rng = random_stream(slot);
+                population.individual(slot) = generator.generate(rng);
+            }
+        }
+
+        /**
+         * Overwrites the individuals in slots [begin, end) of the new generation with the
+         * children of parents from the current population.
+         */
+        void do_crossover(uint32_t begin, uint32_t end) const {
+            assert(population.size() == params.population_size);
+
+            // Each child has its own random stream, so they can be bred in parallel.
+            pool.parallel_for(begin, end, [this] (uint32_t slot) { breed(slot); });
+        }
+
+        /**
+         * Overwrites the individual in a given slot of the new generation with the child of
+         * parents from the current population.
+         */
+        void breed(uint32_t slot) const {
+            auto rng = random_stream(slot);
+
+            // Offspring are bred from the elite and the non-elite individuals, excluding
+            // the worst ones (as many as the new individuals created at each generation).
+            const auto non_elite_size = params.population_size - elite_size - new_individuals_size;
+
+            // Pick a random elite individual.
+            const auto elite_rank = uniform_index(rng, elite_size);
+            const auto& elite = population.ranked_individual(elite_rank);
+
+            // Pick a random non-elite (and non-new) individual.
+            const auto& non_elite = population.ranked_individual(elite_size + uniform_index(rng, non_elite_size));
+
+            // Do biased crossover of the elite and non-elite individuals.
+            auto& child = next_generation.individual(slot);
+
+            if constexpr(traits::has_biased_crossover_into<Individual, Rng>::value) {
+                elite.biased_crossover_into(non_elite, params.crossover_elite_bias, rng, child);
+            } else {
+                child = elite.biased_crossover_with(non_elite, params.crossover_elite_bias, rng);
+            }
+
+            if constexpr(delta_evaluation) { record_lineage(slot, elite_rank, elite, child); }
+        }
+
+        /**
+         * Copies the k-th best individual of the current population into slot k of the new generation,
+         * together with its objective value (its decoded state is moved by \fn take_elite_states).
+         */
+        void copy_elite(uint32_t k) const {
+            next_generation.individual(k) = population.ranked_individual(k);
+            next_generation.set_objvalue(k, population.ranked_objvalue(k));
+        }
+
+        /**
+         * Records the elite parent of the offspring in a given slot, and the positions in which the two differ,
+         * while both chromosomes are still in cache. If they differ in more positions than the evaluator can
+         * handle incrementally, the offspring is recorded as having no parent, and evaluated from scratch.
+         */
+        void record_lineage(uint32_t slot, uint32_t elite_rank, const Individual& parent, const Individual& child) const {
+            const auto max_diff = evaluator.max_delta_diff();
+            auto& diff = diff_positions[slot];
+            diff.clear();
+
+            for(auto i = 0u; i < child.size(); i++) {
+                if(!(child.component(i) == parent.component(i))) {
+                    if(diff.size() == max_diff) {
+                        parent_ranks[slot] = no_parent;
+                        return;
+                    }
+                    diff.push_back(i);
+                }
+            }
+
+            parent_ranks[slot] = elite_rank;
+        }
+
+        /**
+         * Evolves the next generation of individuals, writing it over the buffer of the previous one.
+         * The new generation is made of, in this order: the elite of the current population, the
+         * new (mutant) individuals and the offspring obtained via crossover.
+         */
+        void evolve_new_generation() const {
             assert(population.size() == params.population_size);
+            assert(next_generation.size() == params.population_size);
+
+            const auto mutants_begin = elite_size;
+            const auto offspring_begin = elite_size + new_individuals_size;
 
-            auto it = population.begin();
-            std::advance(it, elite_size);
+            ++generation_count;
+            if constexpr(profiling) { stats = GenerationStats{}; stats.generation = generation_count; }
 
-            // Copy the elite population into the new generation.
-            auto new_generation = Population{population.begin(), it};
+            // Copy the elite population into the new generation, together with the objective values.
+            // Mutants have no parent.
+            if constexpr(delta_evaluation) { std::fill(parent_ranks.begin() + mutants_begin, parent_ranks.begin() + offspring_begin, no_parent); }
 
-            // Insert the mutants (asyncronously).
-            add_new_individuals(new_generation, new_individuals_size);
+            take_elite_states();
 
-            assert(new_generation.size() == elite_size + new_individuals_size);
+            if(params.pipelined_generations) {
+                evolve_pipelined(mutants_begin, offspring_begin);
+            } else {
+                timed(&GenerationStats::elite_copy_s, [this] () {
+                    for(auto k = 0u; k < elite_size; k++) { copy_elite(k); }
+                });
 
-            // Fills the population with crossover.
-            do_crossover(new_generation);
+                // Create the mutants.
+                timed(&GenerationStats::mutants_s, [this,mutants_begin,offspring_begin] () { generate_new_individuals(mutants_begin, offspring_begin); });
 
-            assert(new_generation.size() == params.population_size);
+                // Fills the population with crossover.
+                timed(&GenerationStats::crossover_s, [this,offspring_begin] () { do_crossover(offspring_begin, params.population_size); });
+
+                // Evaluate the mutants and the offspring.
+                timed(&GenerationStats::evaluation_s, [this,mutants_begin] () { evaluate(next_generation, mutants_begin, params.population_size); });
+            }
+
+            timed(&GenerationStats::ranking_s, [this] () {
+                rank(next_generation);
+                anchor_elite(next_generation, next_decoded, next_decoded_valid);
+            });
+
+            if(params.improvement_freq_generations > 0u && generation_count % params.improvement_freq_generations == 0u) {
+                timed(&GenerationStats::improvement_s, [this] () { improve_elite(next_generation, next_decoded, next_decoded_valid); });
+            }
+
+            record_population_stats(next_generation);
+        }
+
+        /**
+         * Fills the new generation, without barriers between the phases (see contract 10): each
+         * individual is evaluated as soon as it is created.
+         */
+        void evolve_pipelined(uint32_t mutants_begin, uint32_t offspring_begin) const {
+            // A generator with its own engine creates the mutants in order, beforehand.
+            if constexpr(!concurrent_generator) {
+                timed(&GenerationStats::mutants_s, [this,mutants_begin,offspring_begin] () { generate_new_individuals(mutants_begin, offspring_begin); });
+            }
+
+            timed(&GenerationStats::evaluation_s, [this,offspring_begin] () {
+                if constexpr(batch_evaluation) {
+                    pool.parallel_for_chunks(0u, params.population_size, [this,offspring_begin] (uint32_t begin, uint32_t end) {
+                        for(auto slot = begin; slot < end; slot++) { create_individual(slot, offspring_begin); }
+                        evaluate_new_chunk(std::max(begin, elite_size), end);
+                    });
+                } else {
+                    pool.parallel_for(0u, params.population_size, [this,offspring_begin] (uint32_t slot) {
+                        create_individual(slot, offspring_begin);
+                        if(slot >= elite_size) { evaluate_new(slot); }
+                    });
+                }
+            });
+
+            if constexpr(profiling) {
+                for(auto slot = mutants_begin; slot < params.population_size; slot++) {
+                    if(cache && cache_hits[slot]) {
+                        ++stats.cache_hits;
+                    } else {
+                        ++stats.evaluations;
+                        stats.evaluation_latency.add(latencies_ns[slot]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Fills a slot of the new generation: with an elite individual, a mutant (unless they are
+         * created beforehand) or an offspring, depending on the slot.
+         */
+        void create_individual(uint32_t slot, uint32_t offspring_begin) const {
+            if(slot < elite_size) {
+                copy_elite(slot);
+            } else if(slot < offspring_begin) {
+                if constexpr(concurrent_generator) { generate_new_individual(next_generation, slot); }
+            } else {
+                breed(slot);
+            }
+        }
+
+        /**
+         * Evaluates the new individual in a given slot of the new generation, unless it is found in the cache.
+         */
+        void evaluate_new(uint32_t slot) const {
+            if constexpr(cacheable) {
+                if(cache) {
+                    auto objvalue = 0.0f;
+                    cache_keys[slot] = cache_key(next_generation.individual(slot));
+                    cache_hits[slot] = cache->lookup(cache_keys[slot], objvalue);
+
+                    if(cache_hits[slot]) {
+                        next_generation.set_objvalue(slot, objvalue);
+                    } else {
+                        evaluate_one(next_generation, slot);
+                        cache->insert(cache_keys[slot], next_generation.objvalue(slot));
+                    }
+
+                    return;
+                }
+            }
+
+            evaluate_one(next_generation, slot);
+        }
+
+        /**
+         * Evaluates the new individuals in slots [begin, end) of the new generation with one call to
+         * the evaluator's batch method, skipping those found in the cache. As in \fn evaluate, the
+         * slots of the individuals which are evaluated are moved to the front of the range.
+         */
+        void evaluate_new_chunk(uint32_t begin, uint32_t end) const {
+            if(begin >= end) { return; }
+
+            if constexpr(cacheable) {
+                if(cache) {
+                    auto misses_end = begin;
+
+                    for(auto slot = begin; slot < end; slot++) {
+                        auto objvalue = 0.0f;
+                        cache_keys[slot] = cache_key(next_generation.individual(slot));
+                        cache_hits[slot] = cache->lookup(cache_keys[slot], objvalue);
+
+                        if(cache_hits[slot]) {
+                            next_generation.set_objvalue(slot, objvalue);
+                            continue;
+                        }
+
+                        if(slot != misses_end) {
+                            swap_slots(next_generation, slot, misses_end);
+                            std::swap(cache_keys[slot], cache_keys[misses_end]);
+                            std::swap(cache_hits[slot], cache_hits[misses_end]);
+                        }
+                        ++misses_end;
+                    }
+
+                    evaluate_chunk(next_generation, begin, misses_end);
+
+                    for(auto slot = begin; slot < misses_end; slot++) {
+                        cache->insert(cache_keys[slot], next_generation.objvalue(slot));
+                    }
+
+                    return;
+                }
+            }
 
-            return new_generation;
+            evaluate_chunk(next_generation, begin, end);
         }
     };
 }
@@ -0,0 +1,163 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_SOLVERTRAITS_H
+#define RKBGA_SOLVERTRAITS_H
+
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include "Span.h"
+#include "FitnessCache.h"
+#include "Profiling.h"
+
+namespace bga {
+    /**
+     * Compile-time detection of the optional parts of the \class Solver contracts.
+     * Each trait is true when the corresponding method is available, in which case
+     * the solver uses it instead of the mandatory (but slower) one.
+     */
+    namespace traits {
+        /**
+         * Individual has: void biased_crossover_into(const Individual&, float, Rng&, Individual&) const;
+         */
+        template<class Individual, class Rng, class = void>
+        struct has_biased_crossover_into : std::false_type {};
+
+        template<class Individual, class Rng>
+        struct has_biased_crossover_into<Individual, Rng, std::void_t<decltype(
+            std::declval<const Individual&>().biased_crossover_into(
+                std::declval<const Individual&>(), 0.0f, std::declval<Rng&>(), std::declval<Individual&>()))>> : std::true_type {};
+
+        /**
+         * Generator has: void generate_into(Individual&) const;
+         */
+        template<class Generator, class Individual, class = void>
+        struct has_generate_into : std::false_type {};
+
+        template<class Generator, class Individual>
+        struct has_generate_into<Generator, Individual, std::void_t<decltype(
+            std::declval<const Generator&>().generate_into(std::declval<Individual&>()))>> : std::true_type {};
+
+        /**
+         * Generator has: Individual generate(Rng&) const;
+         */
+        template<class Generator, class Rng, class = void>
+        struct has_generate_with_rng : std::false_type {};
+
+        template<class Generator, class Rng>
+        struct has_generate_with_rng<Generator, Rng, std::void_t<decltype(
+            std::declval<const Generator&>().generate(std::declval<Rng&>()))>> : std::true_type {};
+
+        /**
+         * Generator has: void generate_into(Individual&, Rng&) const;
+         */
+        template<class Generator, class Individual, class Rng, class = void>
+        struct has_generate_into_with_rng : std::false_type {};
+
+        template<class Generator, class Individual, class Rng>
+        struct has_generate_into_with_rng<Generator, Individual, Rng, std::void_t<decltype(
+            std::declval<const Generator&>().generate_into(std::declval<Individual&>(), std::declval<Rng&>()))>> : std::true_type {};
+
+        /**
+         * Evaluator has: void evaluate_batch(Span<const Individual>, Span<float>) const;
+         */
+        template<class Evaluator, class Individual, class = void>
+        struct has_evaluate_batch : std::false_type {};
+
+        template<class Evaluator, class Individual>
+        struct has_evaluate_batch<Evaluator, Individual, std::void_t<decltype(
+            std::declval<const Evaluator&>().evaluate_batch(
+                std::declval<Span<const Individual>>(), std::declval<Span<float>>()))>> : std::true_type {};
+
+        /**
+         * Evaluator has:
+         *  typedef decoded_type;
+         *  void decode(const Individual&, decoded_type&) const;
+         *  float evaluate_decoded(const decoded_type&) const;
+         *  float evaluate_delta(const Individual&, const Individual&, const decoded_type&, float, Span<const uint32_t>) const;
+         *  uint32_t max_delta_diff() const;
+         */
+        template<class Evaluator, class Individual, class = void>
+        struct has_evaluate_delta : std::false_type {};
+
+        template<class Evaluator, class Individual>
+        struct has_evaluate_delta<Evaluator, Individual, std::void_t<
+            typename Evaluator::decoded_type,
+            decltype(std::declval<const Evaluator&>().decode(
+                std::declval<const Individual&>(), std::declval<typename Evaluator::decoded_type&>())),
+            decltype(std::declval<const Evaluator&>().evaluate_decoded(std::declval<const typename Evaluator::decoded_type&>())),
+            decltype(std::declval<const Evaluator&>().evaluate_delta(
+                std::declval<const Individual&>(), std::declval<const Individual&>(), std::declval<const typename Evaluator::decoded_type&>(),
+                0.0f, std::declval<Span<const uint32_t>>())),
+            decltype(std::declval<const Evaluator&>().max_delta_diff())>> : std::true_type {};
+
+        /**
+         * Placeholder for the decoded state of individuals, when the evaluator has none.
+         */
+        struct NoDecodedState {};
+
+        /**
+         * The decoded state which the solver keeps for each individual: Evaluator::decoded_type
+         * if the evaluator supports delta evaluation, \class NoDecodedState otherwise.
+         */
+        template<class Evaluator, class Individual, bool = has_evaluate_delta<Evaluator, Individual>::value>
+        struct decoded_state { using type = NoDecodedState; };
+
+        template<class Evaluator, class Individual>
+        struct decoded_state<Evaluator, Individual, true> { using type = typename Evaluator::decoded_type; };
+
+        /**
+         * Evaluator has: float improve(Individual&, float) const;
+         */
+        template<class Evaluator, class Individual, class = void>
+        struct has_improve : std::false_type {};
+
+        template<class Evaluator, class Individual>
+        struct has_improve<Evaluator, Individual, std::void_t<decltype(
+            std::declval<const Evaluator&>().improve(std::declval<Individual&>(), 0.0f))>> : std::true_type {};
+
+        /**
+         * Evaluator has: uint64_t hash(const Individual&) const;
+         */
+        template<class Evaluator, class Individual, class = void>
+        struct has_evaluator_hash : std::false_type {};
+
+        template<class Evaluator, class Individual>
+        struct has_evaluator_hash<Evaluator, Individual, std::void_t<decltype(
+            std::declval<const Evaluator&>().hash(std::declval<const Individual&>()))>> : std::true_type {};
+
+        /**
+         * Individual has: uint64_t hash() const;
+         */
+        template<class Individual, class = void>
+        struct has_individual_hash : std::false_type {};
+
+        template<class Individual>
+        struct has_individual_hash<Individual, std::void_t<decltype(
+            std::declval<const Individual&>().hash())>> : std::true_type {};
+
+        /**
+         * Visitor has: void at_cache_stats(const CacheStats&) const;
+         */
+        template<class Visitor, class = void>
+        struct has_at_cache_stats : std::false_type {};
+
+        template<class Visitor>
+        struct has_at_cache_stats<Visitor, std::void_t<decltype(
+            std::declval<const Visitor&>().at_cache_stats(std::declval<const CacheStats&>()))>> : std::true_type {};
+
+        /**
+         * Visitor has: void at_generation_stats(const GenerationStats&) const;
+         */
+        template<class Visitor, class = void>
+        struct has_at_generation_stats : std::false_type {};
+
+        template<class Visitor>
+        struct has_at_generation_stats<Visitor, std::void_t<decltype(
+            std::declval<const Visitor&>().at_generation_stats(std::declval<const GenerationStats&>()))>> : std::true_type {};
+    }
+}
+
+#endif //RKBGA_SOLVERTRAITS_H
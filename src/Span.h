@@ -0,0 +1,43 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_SPAN_H
+#define RKBGA_SPAN_H
+
+#include <cstddef>
+#include <cassert>
+
+namespace bga {
+    /**
+     * Minimal non-owning view over a contiguous sequence of elements, used to pass
+     * batches of individuals and of objective values without copying them.
+     * @tparam T    The type of the elements (const-qualified for read-only views).
+     */
+    template<class T>
+    class Span {
+        /**
+         * First element.
+         */
+        T* first;
+
+        /**
+         * Number of elements.
+         */
+        std::size_t length;
+
+    public:
+        Span(T* first, std::size_t length) : first{first}, length{length} {}
+
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0u; }
+
+        T* data() const { return first; }
+        T* begin() const { return first; }
+        T* end() const { return first + length; }
+
+        T& operator[](std::size_t i) const { assert(i < length); return first[i]; }
+    };
+}
+
+#endif //RKBGA_SPAN_H
@@ -0,0 +1,98 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_SPSCRINGBUFFER_H
+#define RKBGA_SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+namespace bga {
+    /**
+     * Bounded lock-free queue between one producer thread and one consumer thread. Elements are
+     * stored in a ring whose capacity is a power of two; the producer only writes the tail index and
+     * the consumer only writes the head index, so neither side ever waits for the other: pushing
+     * into a full ring, or popping from an empty one, fails immediately.
+     * @tparam T    The type of the elements; it must be trivially copyable.
+     */
+    template<class T>
+    class SpscRingBuffer {
+        static_assert(std::is_trivially_copyable<T>::value, "Elements of the ring buffer must be trivially copyable");
+
+        /**
+         * The ring.
+         */
+        std::vector<T> slots;
+
+        /**
+         * Capacity minus one, to wrap indices around.
+         */
+        const uint64_t mask;
+
+        /**
+         * Number of elements popped so far; written by the consumer only. The indices are on
+         * different cache lines, so that the two threads do not invalidate each other's.
+         */
+        alignas(64) std::atomic<uint64_t> head;
+
+        /**
+         * Number of elements pushed so far; written by the producer only.
+         */
+        alignas(64) std::atomic<uint64_t> tail;
+
+        /**
+         * Smallest power of two not smaller than a given number.
+         */
+        static uint64_t round_up(uint64_t n) {
+            auto capacity = uint64_t{1};
+            while(capacity < n) { capacity <<= 1u; }
+            return capacity;
+        }
+
+    public:
+        /**
+         * Creates the ring.
+         * @param capacity  Minimum number of elements the ring can hold; it is rounded up to a power of two.
+         */
+        explicit SpscRingBuffer(uint64_t capacity) : slots(round_up(capacity)), mask{round_up(capacity) - 1u}, head{0u}, tail{0u} {}
+
+        SpscRingBuffer(const SpscRingBuffer&) = delete;
+        SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+        /**
+         * Appends an element. Must only be called by the producer.
+         * @return  Whether there was room for it.
+         */
+        bool try_push(const T& element) {
+            const auto t = tail.load(std::memory_order_relaxed);
+            if(t - head.load(std::memory_order_acquire) > mask) { return false; }
+
+            slots[t & mask] = element;
+            tail.store(t + 1u, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Removes the oldest element. Must only be called by the consumer.
+         * @return  Whether there was one.
+         */
+        bool try_pop(T& element) {
+            const auto h = head.load(std::memory_order_relaxed);
+            if(h == tail.load(std::memory_order_acquire)) { return false; }
+
+            element = slots[h & mask];
+            head.store(h + 1u, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Maximum number of elements in the ring.
+         */
+        uint64_t capacity() const { return mask + 1u; }
+    };
+}
+
+#endif //RKBGA_SPSCRINGBUFFER_H
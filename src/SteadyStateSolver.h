@@ -0,0 +1,314 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_STEADYSTATESOLVER_H
+#define RKBGA_STEADYSTATESOLVER_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "Params.h"
+#include "Random.h"
+#include "Philox.h"
+#include "ThreadPool.h"
+#include "SolverTraits.h"
+#include "ConcurrentPopulation.h"
+#include "DefaultSolverVisitor.h"
+#include "IndividualWithObjValue.h"
+
+namespace bga {
+    /**
+     * Solves a problem with a steady-state, asynchronous variant of the Biased Genetic Algorithm,
+     * meant for evaluators whose running time varies a lot from individual to individual.
+     * There are no generations, and therefore no barriers: each thread repeatedly creates an
+     * individual, evaluates it, and inserts it in a \class ConcurrentPopulation. A share
+     * Params::replace_share of the population is a tier of mutants: a share Params::replace_share of
+     * the new individuals are mutants, each of which replaces the oldest one in the tier, so that it
+     * stays there for about a generation. The other new individuals are offspring of a random elite
+     * individual (one of the best Params::elite_share) and a random non-elite one (including the
+     * mutants), and replace the worst non-elite individual if they are better; so do mutants, when
+     * they leave the tier. Threads never wait for each other, except for the short time an insertion
+     * takes.
+     *
+     * For the stopping criteria and the visitor, population_size * (1 - elite_share) new individuals
+     * count as a generation. Thread scheduling decides which individuals are in the population when
+     * each one is bred, so runs are not reproducible, even with the same Params::seed.
+     *
+     * The contracts on the template parameters are those of \class Solver, numbers 1 to 4; the other
+     * optional methods (batch and delta evaluation, caching, improvement) are not used.
+     * The visitor is called from one thread at a time.
+     */
+    template<   class Generator,
+                class Evaluator,
+                class Visitor = DefaultSolverVisitor<typename Generator::individual_type>,
+                class Rng = Philox4x32>
+    class SteadyStateSolver {
+        static_assert(std::is_same<typename Generator::individual_type, typename Evaluator::individual_type>::value,
+            "Generator and Evaluator operate on different kind of individuals");
+
+        using Individual = typename Generator::individual_type;
+
+        /**
+         * Genetic Algorithm Parameters.
+         */
+        const Params& params;
+
+        /**
+         * Generator used to produce the initial population and the mutants.
+         */
+        const Generator& generator;
+
+        /**
+         * Evaluator used to obtain the objective function of an individual.
+         */
+        const Evaluator& evaluator;
+
+        /**
+         * Visitor to be called at certain points during the solution process.
+         */
+        const Visitor& visitor;
+
+        /**
+         * Number of elite individuals, which can be picked as the first parent.
+         */
+        const uint32_t elite_size;
+
+        /**
+         * Number of individuals in the mutant tier.
+         */
+        const uint32_t mutants_size;
+
+        /**
+         * Number of new individuals which count as a generation.
+         */
+        const uint64_t generation_size;
+
+        /**
+         * The threads.
+         */
+        mutable ThreadPool pool;
+
+        /**
+         * The population.
+         */
+        mutable ConcurrentPopulation<Individual> population;
+
+        /**
+         * Number of new individuals created so far.
+         */
+        mutable std::atomic<uint64_t> created;
+
+        /**
+         * Value of \member created when the best individual last improved.
+         */
+        mutable std::atomic<uint64_t> last_improvement;
+
+        /**
+         * Objective value of the best individual created so far.
+         */
+        mutable std::atomic<float> best_objvalue;
+
+        /**
+         * Set when a stopping criterion is met.
+         */
+        mutable std::atomic<bool> stopping;
+
+        /**
+         * Serialises the calls to the visitor, and to the generator's own engine.
+         */
+        mutable std::mutex visitor_mtx;
+        mutable std::mutex generator_mtx;
+
+    public:
+        /**
+         * Initialise the algorithm solver. Throws std::invalid_argument if the population has fewer
+         * than two individuals.
+         */
+        SteadyStateSolver(const Params& params, const Generator& generator, const Evaluator& evaluator, const Visitor& visitor) :
+            params{params}, generator{generator}, evaluator{evaluator}, visitor{visitor},
+            elite_size{std::clamp(static_cast<uint32_t>(params.population_size * params.elite_share), 1u, std::max(1u, params.population_size - 1u))},
+            mutants_size{std::min(static_cast<uint32_t>(params.population_size * params.replace_share), params.population_size - elite_size - 1u)},
+            generation_size{std::max(1u, params.population_size - elite_size)},
+            pool{params.num_threads}, created{0u}, last_improvement{0u}, best_objvalue{0.0f}, stopping{false}
+        {
+            if(params.population_size < 2u) { throw std::invalid_argument("The population must have at least two individuals"); }
+        }
+
+        /**
+         * Runs the Genetic Algorithm.
+         * @return  The best individual found.
+         */
+        IndividualWithObjValue<Individual> solve() const {
+            auto start_time = std::chrono::steady_clock::now();
+
+            initialise_population();
+            created = 0u;
+            last_improvement = 0u;
+            best_objvalue = population.best().objvalue;
+            stopping = false;
+
+            visitor.at_start(population.best());
+
+            // One long-running task per thread.
+            pool.parallel_for(0u, pool.size(), [this,start_time] (uint32_t worker) { work(worker, start_time); }, 1u);
+
+            auto end_time = std::chrono::steady_clock::now();
+            auto total_time_s = std::chrono::duration<float>(end_time - start_time).count();
+
+            const auto best = population.best();
+            visitor.at_end(best, static_cast<uint32_t>(created / generation_size), total_time_s);
+
+            return best;
+        }
+
+    private:
+        /**
+         * Random stream used by a thread (or, during initialisation, to create an individual).
+         */
+        Rng random_stream(uint64_t stream) const {
+            return make_engine<Rng>(params.seed, stream);
+        }
+
+        /**
+         * Creates a new random individual, over the storage of an old one.
+         */
+        void generate(Individual& individual, Rng& rng) const {
+            if constexpr(traits::has_generate_into_with_rng<Generator, Individual, Rng>::value) {
+                generator.generate_into(individual, rng);
+            } else if constexpr(traits::has_generate_with_rng<Generator, Rng>::value) {
+                individual = generator.generate(rng);
+            } else {
+                // The generator uses its own engine, which cannot be shared among threads.
+                std::lock_guard<std::mutex> lock{generator_mtx};
+                if constexpr(traits::has_generate_into<Generator, Individual>::value) {
+                    generator.generate_into(individual);
+                } else {
+                    individual = generator.generate();
+                }
+            }
+        }
+
+        /**
+         * Creates and evaluates the initial population, in parallel.
+         */
+        void initialise_population() const {
+            auto individuals = std::vector<Individual>();
+            individuals.reserve(params.population_size);
+
+            if constexpr(traits::has_generate_with_rng<Generator, Rng>::value) {
+                // Each slot has its own random stream, so the individuals are created in parallel.
+                auto randoms = std::vector<std::optional<Individual>>(params.population_size);
+                pool.parallel_for(0u, params.population_size, [this,&randoms] (uint32_t slot) {
+                    auto rng = random_stream(slot);
+                    randoms[slot].emplace(generator.generate(rng));
+                });
+
+                for(auto& individual : randoms) { individuals.push_back(std::move(*individual)); }
+            } else {
+                for(auto slot = 0u; slot < params.population_size; slot++) { individuals.push_back(generator.generate()); }
+
+                // The generator's own individuals only provide the storage, which is overwritten from each slot's random stream.
+                if constexpr(traits::has_generate_into_with_rng<Generator, Individual, Rng>::value) {
+                    pool.parallel_for(0u, params.population_size, [this,&individuals] (uint32_t slot) {
+                        auto rng = random_stream(slot);
+                        generator.generate_into(individuals[slot], rng);
+                    });
+                }
+            }
+
+            auto objvalues = std::vector<float>(params.population_size);
+            pool.parallel_for(0u, params.population_size, [this,&individuals,&objvalues] (uint32_t slot) {
+                objvalues[slot] = evaluator.evaluate(individuals[slot]);
+            });
+
+            population.assign(std::move(individuals), std::move(objvalues), elite_size, mutants_size);
+        }
+
+        /**
+         * Main loop of a thread: creates, evaluates and inserts new individuals until a stopping
+         * criterion is met.
+         * @param worker        Index of the thread, which identifies its random stream.
+         * @param start_time    When the solution process started.
+         */
+        void work(uint32_t worker, std::chrono::steady_clock::time_point start_time) const {
+            // Streams below the population size are used by the initial population.
+            auto rng = random_stream((uint64_t{1} << 32u) | worker);
+            auto individual = population.best().individual;
+
+            const auto non_elite_size = population.non_elite_size();
+            const auto mutant_threshold = static_cast<uint32_t>(params.replace_share * static_cast<float>(1u << 24u));
+
+            while(!stopping.load(std::memory_order_relaxed)) {
+                const auto mutant = uniform_index(rng, 1u << 24u) < mutant_threshold;
+
+                if(mutant) {
+                    generate(individual, rng);
+                } else {
+                    const auto e = uniform_index(rng, elite_size);
+                    const auto n = uniform_index(rng, non_elite_size);
+
+                    population.read_parents(e, n, [this,&rng,&individual] (const Individual& elite, const Individual& non_elite) {
+                        if constexpr(traits::has_biased_crossover_into<Individual, Rng>::value) {
+                            elite.biased_crossover_into(non_elite, params.crossover_elite_bias, rng, individual);
+                        } else {
+                            individual = elite.biased_crossover_with(non_elite, params.crossover_elite_bias, rng);
+                        }
+                    });
+                }
+
+                const auto objvalue = evaluator.evaluate(individual);
+                const auto improved = improves_best(objvalue);
+
+                if(mutant) { population.insert_mutant(individual, objvalue); }
+                else { population.insert(individual, objvalue); }
+
+                const auto count = created.fetch_add(1u) + 1u;
+                if(improved) { last_improvement.store(count); }
+
+                check_progress(count, start_time);
+            }
+        }
+
+        /**
+         * Records a new objective value, if it is (strictly) better than all the previous ones.
+         * @return  Whether it is.
+         */
+        bool improves_best(float objvalue) const {
+            auto best = best_objvalue.load(std::memory_order_relaxed);
+            while(objvalue < best) {
+                if(best_objvalue.compare_exchange_weak(best, objvalue, std::memory_order_relaxed)) { return true; }
+            }
+            return false;
+        }
+
+        /**
+         * Checks the stopping criteria, and calls the visitor each time Params::visitor_freq_iterations
+         * more generations have been done.
+         * @param count         Number of new individuals created so far.
+         * @param start_time    When the solution process started.
+         */
+        void check_progress(uint64_t count, std::chrono::steady_clock::time_point start_time) const {
+            const auto elapsed_time_s = std::chrono::duration<float>(std::chrono::steady_clock::now() - start_time).count();
+            const auto generation = count / generation_size;
+            const auto generations_no_improv = (count - std::min(count, last_improvement.load())) / generation_size;
+
+            if(generation >= params.max_generations || generations_no_improv >= params.max_generations_no_improvement || elapsed_time_s > params.timeout_s) {
+                stopping = true;
+            }
+
+            if(params.visitor_freq_iterations > 0u && count % generation_size == 0u && generation > 0u && generation % params.visitor_freq_iterations == 0u) {
+                std::lock_guard<std::mutex> lock{visitor_mtx};
+                visitor.at_iteration(population.best(), static_cast<uint32_t>(generation), elapsed_time_s);
+            }
+        }
+    };
+}
+
+#endif //RKBGA_STEADYSTATESOLVER_H
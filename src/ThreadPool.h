@@ -0,0 +1,266 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_THREADPOOL_H
+#define RKBGA_THREADPOOL_H
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace bga {
+    /**
+     * Fixed-size pool of long-lived worker threads, used by the solver to run evaluations
+     * in parallel without spawning a new thread for each individual.
+     * Each worker owns a double-ended task queue: it pops tasks from the back of its own
+     * queue and, when that is empty, steals tasks from the front of the other workers' queues.
+     * The thread that submits a batch of work takes part in its execution, so a pool of
+     * size n uses n-1 worker threads plus the calling thread.
+     */
+    class ThreadPool {
+        using Task = std::function<void()>;
+
+        /**
+         * Task queue owned by a worker, and from which other workers can steal.
+         */
+        struct TaskQueue {
+            std::mutex mtx;
+            std::deque<Task> tasks;
+        };
+
+        /**
+         * Book-keeping for a batch of tasks submitted by \fn parallel_for_chunks.
+         */
+        struct Batch {
+            std::atomic<uint32_t> remaining;
+            std::exception_ptr error;
+            std::mutex mtx;
+            std::condition_variable done;
+
+            explicit Batch(uint32_t size) : remaining{size}, error{nullptr} {}
+        };
+
+        /**
+         * One task queue per worker thread.
+         */
+        std::vector<std::unique_ptr<TaskQueue>> queues;
+
+        /**
+         * The worker threads.
+         */
+        std::vector<std::thread> workers;
+
+        /**
+         * Number of tasks currently waiting in any queue.
+         */
+        std::atomic<uint32_t> queued_tasks;
+
+        /**
+         * Queue which will receive the next submitted task (round robin).
+         */
+        std::atomic<uint32_t> next_queue;
+
+        /**
+         * Set when the pool is being destroyed.
+         */
+        std::atomic<bool> stopping;
+
+        /**
+         * Idle workers sleep on this condition variable.
+         */
+        std::mutex sleep_mtx;
+        std::condition_variable sleep_cv;
+
+    public:
+        /**
+         * Creates the pool.
+         * @param num_threads   Total number of threads that execute tasks, including the
+         *                      thread calling \fn parallel_for. If 0, it uses as many threads
+         *                      as the hardware supports.
+         */
+        explicit ThreadPool(uint32_t num_threads) : queued_tasks{0}, next_queue{0}, stopping{false} {
+            if(num_threads == 0) { num_threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+            for(auto i = 0u; i + 1 < num_threads; i++) { queues.push_back(std::make_unique<TaskQueue>()); }
+
+            workers.reserve(queues.size());
+            for(auto i = 0u; i < queues.size(); i++) { workers.emplace_back([this,i] () { work(i); }); }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Stops and joins the worker threads.
+         */
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock{sleep_mtx};
+                stopping = true;
+            }
+            sleep_cv.notify_all();
+            for(auto& worker : workers) { worker.join(); }
+        }
+
+        /**
+         * Total number of threads executing tasks, including the calling thread.
+         */
+        uint32_t size() const { return static_cast<uint32_t>(workers.size()) + 1u; }
+
+        /**
+         * Calls fn(i) for every i in [begin, end), in parallel, and returns when all calls
+         * have completed. The range is split in contiguous chunks, each of which is executed
+         * as a single task. If any call throws, the first exception is rethrown here.
+         * @param begin         First index.
+         * @param end           One past the last index.
+         * @param fn            Function to call on each index.
+         * @param chunk_size    Number of indices per task. If 0, the chunk size is chosen
+         *                      so that each thread receives a few tasks.
+         */
+        template<class Fn>
+        void parallel_for(uint32_t begin, uint32_t end, const Fn& fn, uint32_t chunk_size = 0) {
+            parallel_for_chunks(begin, end, [&fn] (uint32_t chunk_begin, uint32_t chunk_end) {
+                for(auto i = chunk_begin; i < chunk_end; i++) { fn(i); }
+            }, chunk_size);
+        }
+
+        /**
+         * Splits [begin, end) in contiguous chunks and calls fn(chunk_begin, chunk_end) on each of
+         * them, in parallel; returns when all calls have completed. If any call throws, the first
+         * exception is rethrown here.
+         * @param begin         First index.
+         * @param end           One past the last index.
+         * @param fn            Function to call on each chunk.
+         * @param chunk_size    Number of indices per chunk. If 0, the chunk size is chosen
+         *                      so that each thread receives a few chunks.
+         */
+        template<class Fn>
+        void parallel_for_chunks(uint32_t begin, uint32_t end, const Fn& fn, uint32_t chunk_size = 0) {
+            if(begin >= end) { return; }
+
+            const auto n = end - begin;
+
+            if(chunk_size == 0) { chunk_size = std::max(1u, n / (4u * size())); }
+
+            // Nothing to share: run everything on the calling thread.
+            if(workers.empty() || n <= chunk_size) {
+                for(auto chunk_begin = begin; chunk_begin < end; chunk_begin += std::min(chunk_size, end - chunk_begin)) {
+                    fn(chunk_begin, chunk_begin + std::min(chunk_size, end - chunk_begin));
+                }
+                return;
+            }
+
+            const auto num_chunks = (n + chunk_size - 1) / chunk_size;
+            auto batch = Batch{num_chunks};
+
+            for(auto c = 0u; c < num_chunks; c++) {
+                const auto chunk_begin = begin + c * chunk_size;
+                const auto chunk_end = std::min(end, chunk_begin + chunk_size);
+
+                push([&batch,&fn,chunk_begin,chunk_end] () {
+                    try {
+                        fn(chunk_begin, chunk_end);
+                    } catch(...) {
+                        std::lock_guard<std::mutex> lock{batch.mtx};
+                        if(!batch.error) { batch.error = std::current_exception(); }
+                    }
+
+                    std::lock_guard<std::mutex> lock{batch.mtx};
+                    if(--batch.remaining == 0) { batch.done.notify_all(); }
+                });
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{sleep_mtx};
+            }
+            sleep_cv.notify_all();
+
+            // Help the workers until no task is left in the queues, then wait for
+            // the chunks which are still running on other threads.
+            while(batch.remaining > 0) {
+                if(!run_one(static_cast<uint32_t>(queues.size()))) {
+                    std::unique_lock<std::mutex> lock{batch.mtx};
+                    batch.done.wait(lock, [&batch] () { return batch.remaining == 0; });
+                }
+            }
+
+            // The last task might still be holding the lock, wait for it before the batch goes out of scope.
+            std::lock_guard<std::mutex> lock{batch.mtx};
+            if(batch.error) { std::rethrow_exception(batch.error); }
+        }
+
+    private:
+        /**
+         * Enqueues a task, without waking up the workers.
+         */
+        void push(Task task) {
+            auto& queue = *queues[next_queue++ % queues.size()];
+
+            // Count the task before it becomes visible: a thief which pops it right away must not
+            // decrement the counter below zero.
+            ++queued_tasks;
+
+            std::lock_guard<std::mutex> lock{queue.mtx};
+            queue.tasks.push_back(std::move(task));
+        }
+
+        /**
+         * Runs one task, taken from the back of the own queue or stolen from the front of
+         * another queue.
+         * @param id    Index of the calling worker; the thread which submitted the batch
+         *              uses an index past the last queue, so that it only steals.
+         * @return      Whether a task was found.
+         */
+        bool run_one(uint32_t id) {
+            auto task = Task{};
+
+            if(id < queues.size()) {
+                auto& own = *queues[id];
+                std::lock_guard<std::mutex> lock{own.mtx};
+                if(!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                }
+            }
+
+            for(auto k = 1u; !task && k <= queues.size(); k++) {
+                auto& victim = *queues[(id + k) % queues.size()];
+                std::lock_guard<std::mutex> lock{victim.mtx};
+                if(!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                }
+            }
+
+            if(!task) { return false; }
+
+            --queued_tasks;
+            task();
+            return true;
+        }
+
+        /**
+         * Main loop of a worker thread.
+         */
+        void work(uint32_t id) {
+            while(true) {
+                if(run_one(id)) { continue; }
+
+                std::unique_lock<std::mutex> lock{sleep_mtx};
+                sleep_cv.wait(lock, [this] () { return stopping || queued_tasks > 0; });
+                if(stopping && queued_tasks == 0) { return; }
+            }
+        }
+    };
+}
+
+#endif //RKBGA_THREADPOOL_H
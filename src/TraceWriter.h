@@ -0,0 +1,207 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_TRACEWRITER_H
+#define RKBGA_TRACEWRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <fstream>
+#include "SpscRingBuffer.h"
+
+namespace bga {
+    /**
+     * One line of a solver trace, recorded each time the visitor is called.
+     */
+    struct TraceRecord {
+        /**
+         * Iteration (generation) number.
+         */
+        uint32_t iteration;
+
+        /**
+         * Time elapsed since the start of the run, in seconds.
+         */
+        float elapsed_time_s;
+
+        /**
+         * Best, mean and worst objective values in the population.
+         * The last two are 0 if the solver does not collect \class GenerationStats.
+         */
+        float best_objvalue;
+        float mean_objvalue;
+        float worst_objvalue;
+
+        /**
+         * Unused, zeroed: it makes the padding explicit, so binary traces are fully initialised.
+         */
+        uint32_t reserved;
+
+        /**
+         * Number of evaluations and cache hits since the previous record.
+         */
+        uint64_t evaluations;
+        uint64_t cache_hits;
+
+        /**
+         * Time taken by the last generation, in seconds.
+         */
+        double generation_time_s;
+    };
+
+    static_assert(sizeof(TraceRecord) == 48u, "Trace records have a fixed size in binary traces");
+
+    /**
+     * Format of a trace file. Binary traces start with \var trace_magic, the version of the format
+     * and the size of a record (as two uint32_t), followed by the records as they are in memory, in
+     * the byte order of the machine which wrote them.
+     */
+    enum class TraceFormat { Csv, Binary };
+
+    constexpr char trace_magic[8] = {'R', 'K', 'B', 'G', 'A', 'T', 'R', 'C'};
+    constexpr uint32_t trace_version = 1u;
+
+    /**
+     * Writes \class TraceRecord to a file from a background thread, so that the thread running the
+     * solver does no formatting nor I/O. Records are passed through a \class SpscRingBuffer: pushing
+     * never blocks, and if the writer falls behind and the ring is full, the record is dropped and
+     * counted instead. Records must be pushed by one thread at a time.
+     */
+    class TraceWriter {
+        /**
+         * The trace file.
+         */
+        std::ofstream out;
+
+        /**
+         * Format of the trace file.
+         */
+        const TraceFormat format;
+
+        /**
+         * Records waiting to be written.
+         */
+        SpscRingBuffer<TraceRecord> ring;
+
+        /**
+         * Number of records which did not fit in the ring.
+         */
+        std::atomic<uint64_t> dropped;
+
+        /**
+         * Set when no more records will be pushed.
+         */
+        std::atomic<bool> closing;
+
+        /**
+         * The background thread writing the records.
+         */
+        std::thread writer;
+
+        /**
+         * How long the writer sleeps when the ring is empty.
+         */
+        static constexpr auto idle_sleep = std::chrono::milliseconds{1};
+
+    public:
+        /**
+         * Opens the trace file and starts the background thread.
+         * @param filename  Name of the trace file.
+         * @param format    Format of the trace file.
+         * @param capacity  Number of records which can wait to be written.
+         */
+        explicit TraceWriter(const std::string& filename, TraceFormat format = TraceFormat::Csv, uint64_t capacity = 4096u) :
+            out{filename, std::ios::out | std::ios::binary}, format{format}, ring{capacity}, dropped{0u}, closing{false}
+        {
+            if(format == TraceFormat::Binary) {
+                const uint32_t sizes[2] = {trace_version, static_cast<uint32_t>(sizeof(TraceRecord))};
+                out.write(trace_magic, sizeof(trace_magic));
+                out.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+            } else {
+                out << "iteration,time,bestobj,meanobj,worstobj,evaluations,cachehits,generationtime" << std::endl;
+            }
+
+            writer = std::thread{[this] () { drain(); }};
+        }
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        /**
+         * Writes the remaining records and closes the file.
+         */
+        ~TraceWriter() { close(); }
+
+        /**
+         * Queues a record for writing, unless the queue is full. Never blocks.
+         * @return  Whether the record was queued.
+         */
+        bool push(const TraceRecord& record) {
+            if(ring.try_push(record)) { return true; }
+
+            dropped.fetch_add(1u, std::memory_order_relaxed);
+            return false;
+        }
+
+        /**
+         * Waits for the queued records to be written, and closes the file. No record can be pushed afterwards.
+         */
+        void close() {
+            if(!writer.joinable()) { return; }
+
+            closing.store(true, std::memory_order_release);
+            writer.join();
+            out.close();
+        }
+
+        /**
+         * Number of records dropped so far because the queue was full.
+         */
+        uint64_t dropped_records() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        /**
+         * Main loop of the background thread: writes the queued records until the writer is closed
+         * and the queue is empty.
+         */
+        void drain() {
+            auto record = TraceRecord{};
+
+            while(true) {
+                // Read the flag first: records pushed before closing are then written by the loop below.
+                const auto stop = closing.load(std::memory_order_acquire);
+                auto written = false;
+
+                while(ring.try_pop(record)) {
+                    write(record);
+                    written = true;
+                }
+
+                if(stop) { break; }
+                if(written) { out.flush(); }
+
+                std::this_thread::sleep_for(idle_sleep);
+            }
+        }
+
+        /**
+         * Writes one record to the file.
+         */
+        void write(const TraceRecord& record) {
+            if(format == TraceFormat::Binary) {
+                out.write(reinterpret_cast<const char*>(&record), sizeof(TraceRecord));
+                return;
+            }
+
+            out << record.iteration << "," << record.elapsed_time_s << "," << record.best_objvalue << ",";
+            out << record.mean_objvalue << "," << record.worst_objvalue << "," << record.evaluations << ",";
+            out << record.cache_hits << "," << record.generation_time_s << "\n";
+        }
+    };
+}
+
+#endif //RKBGA_TRACEWRITER_H
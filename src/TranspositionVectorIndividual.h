@@ -7,8 +7,9 @@
 
 #include <cstdint>
 #include <vector>
-#include <random>
 #include <cassert>
+#include "Hash.h"
+#include "CrossoverKernels.h"
 
 namespace bga {
     /**
@@ -22,7 +23,7 @@ namespace bga {
         /**
          * The chromosome, made by a vector of unsigned integers.
          */
-        const std::vector<uint32_t> chromosome;
+        std::vector<uint32_t> chromosome;
 
     public:
         /**
@@ -30,9 +31,9 @@ namespace bga {
          * @param chromosome    The transposition chromosome.
          * @return              The newly created individual.
          */
-        TranspositionVectorIndividual(std::vector<uint32_t> chromosome) : chromosome{chromosome} {
+        TranspositionVectorIndividual(std::vector<uint32_t> chromosome) : chromosome{std::move(chromosome)} {
             // Assert that the chromosome's length is even, since it is made of pairs.
-            assert(chromosome.size() % 2 == 0);
+            assert(this->chromosome.size() % 2 == 0);
         }
 
         /**
@@ -44,37 +45,64 @@ namespace bga {
          *              inherit each pair of its chromosome from this individual. Therefore,
          *              the child will have a probability of 1-bias of inheriting each pair of
          *              its chromosome from the other parent.
-         * @param mt    A Mersenne Twister used to tosse the biased coin.
+         * @param rng   A random number generator (e.g., a Mersenne Twister) from which the key of the
+         *              biased coin tosses is drawn (see \file CrossoverKernels.h).
          * @return      The new child.
          */
-        TranspositionVectorIndividual biased_crossover_with(const TranspositionVectorIndividual &other, float bias, std::mt19937& mt) const {
+        template<class Rng>
+        TranspositionVectorIndividual biased_crossover_with(const TranspositionVectorIndividual &other, float bias, Rng& rng) const {
+          auto child = *this;
+          biased_crossover_into(other, bias, rng, child);
+          return child;
+        }
+
+        /**
+         * Same as \fn biased_crossover_with, but writes the new individual over an existing one,
+         * reusing its storage, so that no memory is allocated when the two have the same length.
+         * @param other The other parent individual.
+         * @param bias  Probability of inheriting each pair from this individual.
+         * @param rng   A random number generator used to toss the biased coin.
+         * @param child The individual which will be overwritten by the child.
+         */
+        template<class Rng>
+        void biased_crossover_into(const TranspositionVectorIndividual &other, float bias, Rng& rng, TranspositionVectorIndividual& child) const {
           assert(other.chromosome.size() == chromosome.size());
           assert(0 <= bias && bias <= 1);
+          assert(&child != this && &child != &other);
 
-          // Copy the current chromosome into the new one.
-          auto new_chromosome = chromosome;
+          // Make room for the new chromosome (no-op if the child already has the right length).
+          child.chromosome.resize(chromosome.size());
 
-          // Gives uniformly distributed real numbers in [0,1], used for biased crossover.
-          auto dist = std::uniform_real_distribution<float>(0, 1);
-
-          for(auto i = 0u; i < chromosome.size(); i += 2) {
-              // Toss the coin! :-)
-              float p = dist(mt);
-
-              if(p >= bias) {
-                  // Change the i-th and (i+1)-th components taking them from the other parent.
-                  new_chromosome[i] = other.chromosome[i];
-                  new_chromosome[i+1] = other.chromosome[i+1];
-              }
-          }
-
-          return TranspositionVectorIndividual{new_chromosome};
+          // Toss all the coins at once, one per pair! :-)
+          crossover::biased_crossover(chromosome.data(), other.chromosome.data(), child.chromosome.data(), size(), bias, rng,
+                                      crossover::Granularity::Pair);
         }
 
         /**
          * Return the i-th component of the chromosome.
          */
         uint32_t component(uint32_t i) const { return chromosome[i]; }
+
+        /**
+         * Sets the i-th component of the chromosome.
+         */
+        void set_component(uint32_t i, uint32_t value) { chromosome[i] = value; }
+
+        /**
+         * Returns a pointer to the components of the chromosome, e.g. to overwrite them in bulk.
+         */
+        uint32_t* data() { return chromosome.data(); }
+        const uint32_t* data() const { return chromosome.data(); }
+
+        /**
+         * Returns the length of the chromosome.
+         */
+        uint32_t size() const { return static_cast<uint32_t>(chromosome.size()); }
+
+        /**
+         * Returns a hash of the chromosome.
+         */
+        uint64_t hash() const { return hash_words(chromosome.data(), chromosome.size()); }
     };
 }
 
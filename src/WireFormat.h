@@ -0,0 +1,246 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_WIREFORMAT_H
+#define RKBGA_WIREFORMAT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <algorithm>
+#include "IndividualWithObjValue.h"
+#include "RandomVectorIndividual.h"
+#include "QuantizedRandomVectorIndividual.h"
+#include "TranspositionVectorIndividual.h"
+
+namespace bga {
+    /**
+     * Compact binary serialisation of individuals with their objective values, used to exchange
+     * them between processes. Each record is a self-delimited frame:
+     *
+     *  offset  size    content
+     *  0       4       frame size, in bytes, excluding this field
+     *  4       1       format version (\var wire_format_version)
+     *  5       1       individual type tag (see \class WireCodec)
+     *  6       1       gene width in bytes (1, 2 or 4)
+     *  7       1       reserved (0)
+     *  8       4       objective value
+     *  12      4       number of genes
+     *  16      ...     genes
+     *
+     * Numbers are written in the host's byte order: the format is meant for processes running
+     * on the same machine (or on machines with the same architecture).
+     */
+    constexpr uint8_t wire_format_version = 1u;
+
+    /**
+     * Size of the fixed part of a frame.
+     */
+    constexpr uint32_t wire_header_size = 16u;
+
+    /**
+     * Encoding of the genes of an individual type; must be specialised for each type that
+     * can be sent over the wire, with:
+     *  static constexpr uint8_t type_tag;
+     *  static uint8_t gene_width(const Individual&);
+     *  static void write_genes(const Individual&, uint8_t gene_width, uint8_t* out);
+     *  static std::optional<Individual> read_genes(const uint8_t* in, uint8_t gene_width, uint32_t num_genes);
+     */
+    template<class Individual>
+    struct WireCodec;
+
+    namespace wire {
+        template<class T>
+        inline void store(uint8_t* out, T value) { std::memcpy(out, &value, sizeof(T)); }
+
+        template<class T>
+        inline T load(const uint8_t* in) {
+            auto value = T{};
+            std::memcpy(&value, in, sizeof(T));
+            return value;
+        }
+
+        /**
+         * Writes unsigned integers with the given width (which must fit them).
+         */
+        inline void write_uints(const uint32_t* values, uint32_t count, uint8_t width, uint8_t* out) {
+            for(auto i = 0u; i < count; i++, out += width) {
+                switch(width) {
+                    case 1u: store(out, static_cast<uint8_t>(values[i])); break;
+                    case 2u: store(out, static_cast<uint16_t>(values[i])); break;
+                    default: store(out, values[i]);
+                }
+            }
+        }
+
+        /**
+         * Reads unsigned integers written by \fn write_uints.
+         */
+        inline void read_uints(const uint8_t* in, uint32_t count, uint8_t width, uint32_t* values) {
+            for(auto i = 0u; i < count; i++, in += width) {
+                switch(width) {
+                    case 1u: values[i] = load<uint8_t>(in); break;
+                    case 2u: values[i] = load<uint16_t>(in); break;
+                    default: values[i] = load<uint32_t>(in);
+                }
+            }
+        }
+    }
+
+    /**
+     * Random keys are sent as raw 32-bit floats.
+     */
+    template<>
+    struct WireCodec<RandomVectorIndividual> {
+        static constexpr uint8_t type_tag = 1u;
+
+        static uint8_t gene_width(const RandomVectorIndividual&) { return 4u; }
+
+        static void write_genes(const RandomVectorIndividual& individual, uint8_t, uint8_t* out) {
+            for(auto i = 0u; i < individual.size(); i++, out += 4) { wire::store(out, individual.component(i)); }
+        }
+
+        static std::optional<RandomVectorIndividual> read_genes(const uint8_t* in, uint8_t gene_width, uint32_t num_genes) {
+            if(gene_width != 4u) { return std::nullopt; }
+
+            auto chromosome = std::vector<float>(num_genes);
+            for(auto i = 0u; i < num_genes; i++, in += 4) { chromosome[i] = wire::load<float>(in); }
+
+            return RandomVectorIndividual{std::move(chromosome)};
+        }
+    };
+
+    /**
+     * Quantised random keys are sent as raw 16-bit integers.
+     */
+    template<>
+    struct WireCodec<QuantizedRandomVectorIndividual> {
+        static constexpr uint8_t type_tag = 3u;
+
+        static uint8_t gene_width(const QuantizedRandomVectorIndividual&) { return 2u; }
+
+        static void write_genes(const QuantizedRandomVectorIndividual& individual, uint8_t, uint8_t* out) {
+            std::memcpy(out, individual.data(), individual.size() * sizeof(uint16_t));
+        }
+
+        static std::optional<QuantizedRandomVectorIndividual> read_genes(const uint8_t* in, uint8_t gene_width, uint32_t num_genes) {
+            if(gene_width != 2u) { return std::nullopt; }
+
+            auto chromosome = std::vector<uint16_t>(num_genes);
+            std::memcpy(chromosome.data(), in, num_genes * sizeof(uint16_t));
+
+            return QuantizedRandomVectorIndividual{std::move(chromosome)};
+        }
+    };
+
+    /**
+     * Transpositions are sent with the narrowest integer width that fits the largest item.
+     */
+    template<>
+    struct WireCodec<TranspositionVectorIndividual> {
+        static constexpr uint8_t type_tag = 2u;
+
+        static uint8_t gene_width(const TranspositionVectorIndividual& individual) {
+            auto largest = 0u;
+            for(auto i = 0u; i < individual.size(); i++) { largest = std::max(largest, individual.component(i)); }
+            return (largest <= 0xFFu) ? 1u : (largest <= 0xFFFFu) ? 2u : 4u;
+        }
+
+        static void write_genes(const TranspositionVectorIndividual& individual, uint8_t gene_width, uint8_t* out) {
+            auto genes = std::vector<uint32_t>(individual.size());
+            for(auto i = 0u; i < individual.size(); i++) { genes[i] = individual.component(i); }
+            wire::write_uints(genes.data(), individual.size(), gene_width, out);
+        }
+
+        static std::optional<TranspositionVectorIndividual> read_genes(const uint8_t* in, uint8_t gene_width, uint32_t num_genes) {
+            if(num_genes % 2u != 0u) { return std::nullopt; }
+
+            auto chromosome = std::vector<uint32_t>(num_genes);
+            wire::read_uints(in, num_genes, gene_width, chromosome.data());
+
+            // The chromosome of a permutation of n items has 2(n-1) genes, each one an item.
+            const auto num_items = num_genes / 2u + 1u;
+            for(const auto gene : chromosome) { if(gene >= num_items) { return std::nullopt; } }
+
+            return TranspositionVectorIndividual{std::move(chromosome)};
+        }
+    };
+
+    /**
+     * Appends the frame of an individual, with its objective value, to a buffer.
+     * @param individual    The individual.
+     * @param objvalue      Its objective value.
+     * @param out           The buffer.
+     */
+    template<class Individual>
+    void serialise(const Individual& individual, float objvalue, std::vector<uint8_t>& out) {
+        using Codec = WireCodec<Individual>;
+
+        const auto num_genes = static_cast<uint32_t>(individual.size());
+        const auto gene_width = Codec::gene_width(individual);
+        const auto size = wire_header_size + num_genes * gene_width;
+
+        const auto offset = out.size();
+        out.resize(offset + size);
+
+        auto frame = out.data() + offset;
+        wire::store<uint32_t>(frame, size - 4u);
+        frame[4] = wire_format_version;
+        frame[5] = Codec::type_tag;
+        frame[6] = gene_width;
+        frame[7] = 0u;
+        wire::store<float>(frame + 8, objvalue);
+        wire::store<uint32_t>(frame + 12, num_genes);
+
+        Codec::write_genes(individual, gene_width, frame + wire_header_size);
+    }
+
+    /**
+     * Appends the frame of an individual, with its objective value, to a buffer.
+     * @param record    The individual and its objective value.
+     * @param out       The buffer.
+     */
+    template<class Individual>
+    void serialise(const IndividualWithObjValue<Individual>& record, std::vector<uint8_t>& out) {
+        serialise(record.individual, record.objvalue, out);
+    }
+
+    /**
+     * Total size of the frame which starts at the given position, or 0 if fewer than
+     * four bytes are available.
+     */
+    inline std::size_t frame_size(const uint8_t* data, std::size_t available) {
+        return (available < 4u) ? 0u : static_cast<std::size_t>(wire::load<uint32_t>(data)) + 4u;
+    }
+
+    /**
+     * Reads an individual, with its objective value, from a complete frame.
+     * @param frame The frame, starting with its size field.
+     * @param size  Number of bytes of the frame.
+     * @return      The record, or nothing if the frame is malformed (including genes which
+     *              cannot belong to a valid individual), or was written with another format
+     *              version, or for another type of individual.
+     */
+    template<class Individual>
+    std::optional<IndividualWithObjValue<Individual>> deserialise(const uint8_t* frame, std::size_t size) {
+        using Codec = WireCodec<Individual>;
+
+        if(size < wire_header_size || frame_size(frame, size) != size) { return std::nullopt; }
+        if(frame[4] != wire_format_version || frame[5] != Codec::type_tag) { return std::nullopt; }
+
+        const auto gene_width = frame[6];
+        const auto num_genes = wire::load<uint32_t>(frame + 12);
+
+        if(gene_width != 1u && gene_width != 2u && gene_width != 4u) { return std::nullopt; }
+        if(size != wire_header_size + static_cast<std::size_t>(num_genes) * gene_width) { return std::nullopt; }
+
+        auto individual = Codec::read_genes(frame + wire_header_size, gene_width, num_genes);
+        if(!individual) { return std::nullopt; }
+
+        return IndividualWithObjValue<Individual>(std::move(*individual), wire::load<float>(frame + 8));
+    }
+}
+
+#endif //RKBGA_WIREFORMAT_H
@@ -0,0 +1,62 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_XOSHIRO256PP_H
+#define RKBGA_XOSHIRO256PP_H
+
+#include <array>
+#include <limits>
+#include <cstdint>
+#include "Random.h"
+
+namespace bga {
+    /**
+     * The xoshiro256++ generator (Blackman and Vigna, "Scrambled linear pseudorandom number
+     * generators", 2021): 256 bits of state and 64 random bits per call, with a handful of
+     * additions, shifts and rotations. Streams are obtained by expanding the seed and the stream
+     * identifier into the state with SplitMix64; they are not guaranteed to be disjoint, but the
+     * probability that two of them overlap is negligible.
+     * It satisfies the UniformRandomBitGenerator requirements.
+     */
+    class Xoshiro256pp {
+        std::array<uint64_t, 4> state;
+
+        static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    public:
+        using result_type = uint64_t;
+
+        /**
+         * Creates a stream.
+         * @param seed      The seed, shared by all streams of a run.
+         * @param stream    Identifier of the stream.
+         */
+        Xoshiro256pp(uint64_t seed, uint64_t stream) {
+            const auto base = derive_seed(seed, stream);
+            for(auto i = 0u; i < state.size(); i++) { state[i] = derive_seed(base, i); }
+        }
+
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        /**
+         * Returns the next 64 random bits of the stream.
+         */
+        result_type operator()() {
+            const auto result = rotl(state[0] + state[3], 23) + state[0];
+            const auto t = state[1] << 17u;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+
+            return result;
+        }
+    };
+}
+
+#endif //RKBGA_XOSHIRO256PP_H
@@ -0,0 +1,68 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_TESTS_CHECK_H
+#define RKBGA_TESTS_CHECK_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * A minimal test harness, so that the tests need nothing but the standard library. Each test is
+ * a function registered with \def RKBGA_TEST; checks which fail throw a \class CheckFailure, which
+ * stops the test and is reported by \file main.cpp.
+ */
+namespace bga {
+    namespace tests {
+        struct CheckFailure : std::runtime_error {
+            using std::runtime_error::runtime_error;
+        };
+
+        struct TestCase {
+            const char* name;
+            void (*run)();
+        };
+
+        /**
+         * All the registered tests, in registration order.
+         */
+        inline std::vector<TestCase>& registry() {
+            static auto tests = std::vector<TestCase>();
+            return tests;
+        }
+
+        struct Registrar {
+            Registrar(const char* name, void (*run)()) { registry().push_back(TestCase{name, run}); }
+        };
+
+        inline void fail(const char* file, int line, const std::string& message) {
+            auto out = std::ostringstream{};
+            out << file << ":" << line << ": " << message;
+            throw CheckFailure{out.str()};
+        }
+    }
+}
+
+#define RKBGA_TEST(name) \
+    static void name(); \
+    static const bga::tests::Registrar name##_registrar{#name, name}; \
+    static void name()
+
+#define RKBGA_CHECK(condition) \
+    do { if(!(condition)) { bga::tests::fail(__FILE__, __LINE__, "check failed: " #condition); } } while(false)
+
+#define RKBGA_CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        const auto rkbga_actual = static_cast<double>(actual); \
+        const auto rkbga_expected = static_cast<double>(expected); \
+        if(!(rkbga_actual - rkbga_expected <= (tolerance) && rkbga_expected - rkbga_actual <= (tolerance))) { \
+            auto rkbga_message = std::ostringstream{}; \
+            rkbga_message << "check failed: " #actual " == " #expected " (" << rkbga_actual << " vs " << rkbga_expected << ")"; \
+            bga::tests::fail(__FILE__, __LINE__, rkbga_message.str()); \
+        } \
+    } while(false)
+
+#endif //RKBGA_TESTS_CHECK_H
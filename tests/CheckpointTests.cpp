@@ -0,0 +1,92 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/DefaultRandomVectorGenerator.h"
+#include "../src/DefaultTranspositionVectorGenerator.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/Checkpoint.h"
+#include "../src/Solver.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/RandomVectorEvaluator.h"
+#include "../examples/tsp/TranspositionVectorEvaluator.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    /**
+     * Runs 40 generations on gr48 in one go, and again as 15 generations saved to a checkpoint and
+     * resumed from it for the other 25; checks that both runs find the same best individual.
+     */
+    template<class Generator, class Evaluator>
+    void check_resumed_run(const std::string& name) {
+        using Individual = typename Generator::individual_type;
+        using Visitor = tests::SilentVisitor<Individual>;
+        using Solver = bga::Solver<Generator, Evaluator, Visitor>;
+
+        const auto graph = Graph{tests::instance("gr48")};
+        const auto generator = Generator{graph.num_nodes(), 1u};
+        const auto evaluator = Evaluator{graph};
+        const auto visitor = Visitor{};
+        const auto file = "/tmp/rkbga-test-" + std::to_string(::getpid()) + "-" + name + ".checkpoint";
+
+        auto builder = ParamsBuilder{}.with_population_size(80u).with_num_threads(2u).with_seed(31u);
+        const auto uninterrupted_params = ParamsBuilder{builder}.with_max_generations(40u).build();
+        const auto interrupted_params = ParamsBuilder{builder}.with_max_generations(15u).with_checkpoint_freq_generations(5u)
+                                                              .with_checkpoint_file(file).build();
+
+        const auto uninterrupted = Solver{uninterrupted_params, generator, evaluator, visitor}.solve();
+        Solver{interrupted_params, generator, evaluator, visitor}.solve();
+
+        auto checkpoint = read_checkpoint<Individual>(file);
+        std::remove(file.c_str());
+        RKBGA_CHECK(checkpoint.has_value());
+        RKBGA_CHECK(checkpoint->state.generation == 15u);
+
+        const auto resumed = Solver{uninterrupted_params, generator, evaluator, visitor, std::move(*checkpoint)}.solve();
+
+        RKBGA_CHECK(resumed.objvalue == uninterrupted.objvalue);
+        RKBGA_CHECK(resumed.individual.size() == uninterrupted.individual.size());
+        for(auto i = 0u; i < resumed.individual.size(); i++) {
+            RKBGA_CHECK(resumed.individual.component(i) == uninterrupted.individual.component(i));
+        }
+    }
+}
+
+RKBGA_TEST(resumed_run_matches_uninterrupted_random_keys) {
+    check_resumed_run<DefaultRandomVectorGenerator, RandomVectorEvaluator>("random-key");
+}
+
+RKBGA_TEST(resumed_run_matches_uninterrupted_transpositions) {
+    check_resumed_run<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>("transposition");
+}
+
+RKBGA_TEST(unwritable_checkpoint_fails_the_run) {
+    using Visitor = tests::SilentVisitor<RandomVectorIndividual>;
+
+    const auto graph = Graph{tests::instance("gr17")};
+    const auto generator = DefaultRandomVectorGenerator{graph.num_nodes(), 1u};
+    const auto evaluator = RandomVectorEvaluator{graph};
+    const auto visitor = Visitor{};
+    const auto params = ParamsBuilder{}.with_population_size(20u).with_max_generations(10u).with_num_threads(1u)
+                                       .with_checkpoint_freq_generations(5u).with_checkpoint_file("/nonexistent/rkbga.checkpoint").build();
+
+    auto thrown = false;
+    try {
+        Solver<DefaultRandomVectorGenerator, RandomVectorEvaluator, Visitor>{params, generator, evaluator, visitor}.solve();
+    } catch(const std::runtime_error&) {
+        thrown = true;
+    }
+
+    RKBGA_CHECK(thrown);
+}
@@ -0,0 +1,128 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/DefaultTranspositionVectorGenerator.h"
+#include "../src/Philox.h"
+#include "../src/Random.h"
+#include "../src/SolverTraits.h"
+#include "../src/Span.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/TranspositionVectorEvaluator.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    static_assert(traits::has_evaluate_delta<TranspositionVectorEvaluator, TranspositionVectorIndividual>::value,
+        "The solver does not evaluate transposition vectors incrementally");
+
+    /**
+     * Positions in which two chromosomes differ, as the solver records them.
+     */
+    std::vector<uint32_t> diff_positions(const TranspositionVectorIndividual& parent, const TranspositionVectorIndividual& child) {
+        auto diff = std::vector<uint32_t>();
+        for(auto i = 0u; i < child.size(); i++) {
+            if(child.component(i) != parent.component(i)) { diff.push_back(i); }
+        }
+        return diff;
+    }
+
+    /**
+     * Checks that the incremental cost of a child is the cost of its tour.
+     */
+    void check_delta(const TranspositionVectorEvaluator& evaluator, const TranspositionVectorIndividual& parent, const TranspositionVectorIndividual& child) {
+        auto parent_tour = std::vector<uint32_t>();
+        evaluator.decode(parent, parent_tour);
+
+        const auto parent_cost = evaluator.evaluate_decoded(parent_tour);
+        const auto diff = diff_positions(parent, child);
+        const auto expected = evaluator.evaluate(child);
+        const auto actual = evaluator.evaluate_delta(child, parent, parent_tour, parent_cost, Span<const uint32_t>{diff.data(), diff.size()});
+
+        RKBGA_CHECK_NEAR(actual, expected, 1e-4 * expected);
+    }
+
+    /**
+     * Changes the given pairs of a chromosome into random transpositions.
+     */
+    template<class Rng>
+    TranspositionVectorIndividual change_pairs(const TranspositionVectorIndividual& parent, const std::vector<uint32_t>& pairs, uint32_t n, Rng& rng) {
+        auto chromosome = std::vector<uint32_t>(parent.size());
+        for(auto i = 0u; i < parent.size(); i++) { chromosome[i] = parent.component(i); }
+
+        for(const auto pair : pairs) {
+            chromosome[2u * pair] = uniform_index(rng, n);
+            chromosome[2u * pair + 1u] = uniform_index(rng, n);
+        }
+
+        return TranspositionVectorIndividual{std::move(chromosome)};
+    }
+}
+
+RKBGA_TEST(delta_evaluation_matches_full_evaluation) {
+    for(const auto& name : {"gr17", "gr48", "pa561"}) {
+        const auto graph = Graph{tests::instance(name)};
+        const auto evaluator = TranspositionVectorEvaluator{graph};
+        const auto generator = DefaultTranspositionVectorGenerator{graph.num_nodes()};
+        const auto n = graph.num_nodes();
+        const auto last = n - 2u;
+
+        auto rng = make_engine<Philox4x32>(5u, 0u);
+
+        for(auto trial = 0u; trial < 50u; trial++) {
+            const auto parent = generator.generate(rng);
+
+            // Up to the number of pairs evaluated incrementally, and more than that.
+            for(auto num_pairs = 1u; num_pairs <= evaluator.max_delta_diff() / 2u + 1u; num_pairs++) {
+                auto pairs = std::vector<uint32_t>();
+                for(auto j = 0u; j < num_pairs; j++) { pairs.push_back(uniform_index(rng, n - 1u)); }
+                std::sort(pairs.begin(), pairs.end());
+                check_delta(evaluator, parent, change_pairs(parent, pairs, n, rng));
+            }
+
+            // The first and last pairs, and consecutive ones, whose transpositions interact.
+            check_delta(evaluator, parent, change_pairs(parent, {0u}, n, rng));
+            check_delta(evaluator, parent, change_pairs(parent, {last}, n, rng));
+            check_delta(evaluator, parent, change_pairs(parent, {0u, last}, n, rng));
+            check_delta(evaluator, parent, change_pairs(parent, {last - 2u, last - 1u, last}, n, rng));
+
+            // Offspring of a very biased crossover differ in a few positions, sometimes in one of a pair.
+            const auto other = generator.generate(rng);
+            check_delta(evaluator, parent, parent.biased_crossover_with(other, 0.995f, rng));
+            check_delta(evaluator, parent, parent);
+        }
+    }
+}
+
+RKBGA_TEST(delta_evaluation_chains_stay_close_to_full_evaluation) {
+    const auto graph = Graph{tests::instance("pa561")};
+    const auto evaluator = TranspositionVectorEvaluator{graph};
+    const auto generator = DefaultTranspositionVectorGenerator{graph.num_nodes()};
+    const auto n = graph.num_nodes();
+
+    auto rng = make_engine<Philox4x32>(9u, 0u);
+    auto parent = generator.generate(rng);
+    auto tour = std::vector<uint32_t>();
+    evaluator.decode(parent, tour);
+    auto cost = evaluator.evaluate_decoded(tour);
+
+    // A long lineage, which the solver would re-anchor whenever an offspring enters the elite.
+    for(auto step = 0u; step < 200u; step++) {
+        const auto child = change_pairs(parent, {uniform_index(rng, n - 1u)}, n, rng);
+        const auto diff = diff_positions(parent, child);
+        cost = evaluator.evaluate_delta(child, parent, tour, cost, Span<const uint32_t>{diff.data(), diff.size()});
+
+        parent = child;
+        evaluator.decode(parent, tour);
+    }
+
+    RKBGA_CHECK_NEAR(cost, evaluator.evaluate(parent), 1e-3 * cost);
+}
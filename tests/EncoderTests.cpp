@@ -0,0 +1,101 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/DefaultRandomVectorGenerator.h"
+#include "../src/DefaultTranspositionVectorGenerator.h"
+#include "../src/PermutationEncoder.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/Philox.h"
+#include "../src/Random.h"
+#include "../src/Solver.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/RandomVectorEvaluator.h"
+#include "../examples/tsp/TranspositionVectorEvaluator.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    /**
+     * A random permutation of 0, ..., n-1.
+     */
+    std::vector<uint32_t> random_tour(uint32_t n, uint64_t seed) {
+        auto rng = make_engine<Philox4x32>(seed, 0u);
+        auto tour = std::vector<uint32_t>(n);
+        std::iota(tour.begin(), tour.end(), 0u);
+        for(auto i = n; i > 1u; i--) { std::swap(tour[i - 1u], tour[uniform_index(rng, i)]); }
+        return tour;
+    }
+
+    /**
+     * Checks that the individual which an encoder builds from a tour decodes back to the same tour,
+     * on instances of different sizes.
+     */
+    template<class Encoder, class Evaluator>
+    void check_round_trip(const Encoder& encode) {
+        for(const auto& name : {"gr17", "gr48", "pa561"}) {
+            const auto graph = Graph{tests::instance(name)};
+            const auto evaluator = Evaluator{graph};
+
+            for(auto seed = 0u; seed < 5u; seed++) {
+                const auto tour = random_tour(graph.num_nodes(), seed);
+                auto decoded = std::vector<uint32_t>();
+                evaluator.decode(encode(tour), decoded);
+                RKBGA_CHECK(decoded == tour);
+            }
+        }
+    }
+
+    /**
+     * Solves gr48, then seeds the best tour found into a new solver's initial population, which
+     * must then hold it as its best individual.
+     */
+    template<class Generator, class Evaluator, class Encoder>
+    void check_seeded_population(const Encoder& encode) {
+        using Individual = typename Generator::individual_type;
+        using Visitor = tests::SilentVisitor<Individual>;
+        using Solver = bga::Solver<Generator, Evaluator, Visitor>;
+
+        const auto graph = Graph{tests::instance("gr48")};
+        const auto generator = Generator{graph.num_nodes(), 1u};
+        const auto evaluator = Evaluator{graph};
+        const auto visitor = Visitor{};
+        const auto params = ParamsBuilder{}.with_population_size(50u).with_max_generations(60u).with_num_threads(2u).with_seed(8u).build();
+
+        auto tour = std::vector<uint32_t>();
+        evaluator.decode(Solver{params, generator, evaluator, visitor}.solve().individual, tour);
+
+        const auto seeded = Solver{params, generator, evaluator, visitor};
+        seeded.seed_population(std::vector<std::vector<uint32_t>>{tour}, encode);
+        seeded.initialise();
+
+        auto best_tour = std::vector<uint32_t>();
+        evaluator.decode(seeded.best().individual, best_tour);
+        RKBGA_CHECK(best_tour == tour);
+        RKBGA_CHECK_NEAR(seeded.best().objvalue, graph.tour_cost(tour), 1e-3 * graph.tour_cost(tour));
+    }
+}
+
+RKBGA_TEST(random_key_encoding_round_trips) {
+    check_round_trip<RandomKeyEncoder, RandomVectorEvaluator>(RandomKeyEncoder{});
+}
+
+RKBGA_TEST(transposition_encoding_round_trips) {
+    check_round_trip<TranspositionEncoder, TranspositionVectorEvaluator>(TranspositionEncoder{});
+}
+
+RKBGA_TEST(seeded_tour_enters_the_initial_population_random_keys) {
+    check_seeded_population<DefaultRandomVectorGenerator, RandomVectorEvaluator>(RandomKeyEncoder{});
+}
+
+RKBGA_TEST(seeded_tour_enters_the_initial_population_transpositions) {
+    check_seeded_population<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>(TranspositionEncoder{});
+}
@@ -0,0 +1,125 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/FixedRandomVectorGenerator.h"
+#include "../src/FixedTranspositionVectorGenerator.h"
+#include "../src/QuantizedRandomVectorGenerator.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/Solver.h"
+
+#include "../examples/tsp/Graph.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    /**
+     * Number of nodes of gr17, which fixes the length of the compile-time individuals.
+     */
+    constexpr uint32_t gr17_nodes = 17u;
+
+    /**
+     * Evaluator of random-key individuals of any kind, which sorts the nodes by key.
+     */
+    template<class Individual>
+    struct KeyTourEvaluator {
+        using individual_type = Individual;
+
+        const Graph& graph;
+
+        void decode(const Individual& individual, std::vector<uint32_t>& tour) const {
+            tour.resize(individual.size());
+            std::iota(tour.begin(), tour.end(), 0u);
+            std::stable_sort(tour.begin(), tour.end(), [&] (auto i, auto j) { return individual.component(i) < individual.component(j); });
+        }
+
+        float evaluate(const Individual& individual) const {
+            auto tour = std::vector<uint32_t>();
+            decode(individual, tour);
+            return graph.tour_cost(tour);
+        }
+    };
+
+    /**
+     * Evaluator of transposition individuals of any kind, which applies the swaps to the identity.
+     */
+    template<class Individual>
+    struct TranspositionTourEvaluator {
+        using individual_type = Individual;
+
+        const Graph& graph;
+
+        void decode(const Individual& individual, std::vector<uint32_t>& tour) const {
+            tour.resize(individual.size() / 2u + 1u);
+            std::iota(tour.begin(), tour.end(), 0u);
+            for(auto i = 0u; i < individual.size(); i += 2u) { std::swap(tour[individual.component(i)], tour[individual.component(i + 1u)]); }
+        }
+
+        float evaluate(const Individual& individual) const {
+            auto tour = std::vector<uint32_t>();
+            decode(individual, tour);
+            return graph.tour_cost(tour);
+        }
+    };
+
+    /**
+     * Solves gr17 with a given kind of individual, and checks that the best objective value is
+     * the cost of the tour the best individual decodes to.
+     */
+    template<template<class> class Evaluator, class Generator>
+    void solve_gr17(const Generator& generator) {
+        using Individual = typename Generator::individual_type;
+        using Visitor = tests::SilentVisitor<Individual>;
+
+        const auto graph = Graph{tests::instance("gr17")};
+        const auto params = ParamsBuilder{}.with_population_size(50u).with_max_generations(30u).with_num_threads(2u).with_seed(3u).build();
+        const auto evaluator = Evaluator<Individual>{graph};
+        const auto visitor = Visitor{};
+
+        const auto best = Solver<Generator, Evaluator<Individual>, Visitor>{params, generator, evaluator, visitor}.solve();
+        tests::check_best_matches_tour(evaluator, graph, best);
+    }
+}
+
+RKBGA_TEST(solver_runs_with_fixed_random_keys) {
+    solve_gr17<KeyTourEvaluator>(FixedRandomVectorGenerator<gr17_nodes>{1u});
+}
+
+RKBGA_TEST(solver_runs_with_fixed_transpositions) {
+    solve_gr17<TranspositionTourEvaluator>(FixedTranspositionVectorGenerator<gr17_nodes>{1u});
+}
+
+RKBGA_TEST(solver_runs_with_quantized_random_keys) {
+    solve_gr17<KeyTourEvaluator>(QuantizedRandomVectorGenerator<>{gr17_nodes, 1u});
+}
+
+RKBGA_TEST(fixed_transposition_data_is_the_chromosome) {
+    auto individual = FixedTranspositionVectorGenerator<gr17_nodes>{2u}.generate();
+    individual.data()[3] = 5u;
+
+    const auto& constant = individual;
+    RKBGA_CHECK(individual.component(3u) == 5u);
+    RKBGA_CHECK(constant.data() == individual.data());
+}
+
+RKBGA_TEST(quantized_decoding_sorts_by_key_then_position) {
+    // Short chromosomes are decoded by comparison sort, long ones (with many ties) by radix sort.
+    for(const auto length : {17u, 100u, 1000u, 100000u}) {
+        const auto individual = QuantizedRandomVectorGenerator<>{length, 4u}.generate();
+
+        auto expected = std::vector<uint32_t>(length);
+        std::iota(expected.begin(), expected.end(), 0u);
+        std::stable_sort(expected.begin(), expected.end(), [&] (auto i, auto j) { return individual.component(i) < individual.component(j); });
+
+        auto permutation = std::vector<uint32_t>();
+        individual.decode(permutation);
+        RKBGA_CHECK(permutation == expected);
+    }
+}
@@ -0,0 +1,52 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/DefaultRandomVectorGenerator.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/IslandSolver.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/RandomVectorEvaluator.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    using Visitor = tests::SilentVisitor<RandomVectorIndividual>;
+    using Islands = IslandSolver<DefaultRandomVectorGenerator, RandomVectorEvaluator, Visitor>;
+
+    /**
+     * Solves gr48 with three islands, and checks that the best objective value is the cost of
+     * the tour the best individual decodes to.
+     */
+    void solve_with_migration_every(uint32_t migration_freq_generations, uint32_t visitor_freq_iterations = 10u) {
+        const auto graph = Graph{tests::instance("gr48")};
+        const auto params = ParamsBuilder{}.with_population_size(60u).with_max_generations(40u).with_num_islands(3u)
+                                           .with_num_threads(1u).with_migration_freq_generations(migration_freq_generations)
+                                           .with_visitor_freq_iterations(visitor_freq_iterations).with_seed(23u).build();
+        const auto generator = DefaultRandomVectorGenerator{graph.num_nodes()};
+        const auto evaluator = RandomVectorEvaluator{graph};
+        const auto visitor = Visitor{};
+
+        const auto best = Islands{params, generator, evaluator, visitor}.solve();
+        tests::check_best_matches_tour(evaluator, graph, best);
+    }
+}
+
+RKBGA_TEST(island_solver_migrates) {
+    solve_with_migration_every(5u);
+}
+
+RKBGA_TEST(island_solver_without_migration) {
+    // A migration frequency of 0 turns migration off, rather than dividing by zero.
+    solve_with_migration_every(0u);
+}
+
+RKBGA_TEST(island_solver_without_visitor_calls) {
+    // So does a visitor frequency of 0, which only leaves the calls at the start and at the end.
+    solve_with_migration_every(5u, 0u);
+}
@@ -0,0 +1,56 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include <random>
+#include "Check.h"
+#include "../src/Population.h"
+
+using namespace bga;
+
+namespace {
+    /**
+     * A population of n integers whose objective values are given, with many ties.
+     */
+    Population<uint32_t> make_population(const std::vector<float>& objvalues) {
+        auto population = Population<uint32_t>{};
+        for(auto slot = 0u; slot < objvalues.size(); slot++) { population.add(slot, objvalues[slot]); }
+        return population;
+    }
+}
+
+RKBGA_TEST(population_rank_partitions_and_sorts) {
+    auto rng = std::mt19937{5u};
+    auto values = std::vector<float>(200u);
+    for(auto& value : values) { value = static_cast<float>(rng() % 50u); }
+
+    auto population = make_population(values);
+    population.rank(20u, 180u);
+
+    for(auto k = 1u; k < 20u; k++) { RKBGA_CHECK(population.ranked_objvalue(k - 1u) <= population.ranked_objvalue(k)); }
+    for(auto k = 20u; k < 180u; k++) { RKBGA_CHECK(population.ranked_objvalue(19u) <= population.ranked_objvalue(k)); }
+    for(auto k = 180u; k < 200u; k++) {
+        for(auto j = 20u; j < 180u; j++) { RKBGA_CHECK(population.ranked_objvalue(j) <= population.ranked_objvalue(k)); }
+    }
+}
+
+RKBGA_TEST(population_rank_does_not_depend_on_previous_ranking) {
+    auto rng = std::mt19937{6u};
+    auto values = std::vector<float>(200u);
+    for(auto& value : values) { value = static_cast<float>(rng() % 50u); }
+
+    // The same objective values, but ranked after different histories: the parents are picked
+    // by rank, so a different order within the unsorted ranges would change the run.
+    auto fresh = make_population(values);
+
+    auto reused = make_population(values);
+    for(auto slot = 0u; slot < reused.size(); slot++) { reused.set_objvalue(slot, static_cast<float>(rng() % 1000u)); }
+    reused.rank(20u, 180u);
+    for(auto slot = 0u; slot < reused.size(); slot++) { reused.set_objvalue(slot, values[slot]); }
+
+    fresh.rank(20u, 180u);
+    reused.rank(20u, 180u);
+
+    for(auto k = 0u; k < fresh.size(); k++) { RKBGA_CHECK(fresh.ranked_slot(k) == reused.ranked_slot(k)); }
+}
@@ -0,0 +1,103 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+#include "Check.h"
+
+#include "../src/SocketChannel.h"
+
+using namespace bga;
+
+namespace {
+    /**
+     * A non-blocking Unix socket listening with the smallest backlog, which the test accepts
+     * from by hand.
+     */
+    struct Listener {
+        int fd;
+        sockaddr_un address;
+
+        explicit Listener(const std::string& path) : fd{::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0)}, address{} {
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1u);
+            ::unlink(path.c_str());
+            ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+            ::listen(fd, 0);
+        }
+
+        ~Listener() {
+            ::close(fd);
+            ::unlink(address.sun_path);
+        }
+
+        /**
+         * Accepts a connection, waiting up to one second for it.
+         */
+        int accept() const {
+            auto pfd = pollfd{fd, POLLIN, 0};
+            if(::poll(&pfd, 1, 1000) <= 0) { return -1; }
+            return ::accept(fd, nullptr, nullptr);
+        }
+
+        /**
+         * Connects non-blocking sockets, without accepting them, until the backlog is full.
+         */
+        std::vector<int> fill_backlog() const {
+            auto pending = std::vector<int>();
+
+            while(pending.size() < 64u) {
+                const auto client = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+                if(::connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+                    ::close(client);
+                    break;
+                }
+                pending.push_back(client);
+            }
+
+            return pending;
+        }
+    };
+
+    std::string socket_path(const std::string& name) {
+        return "/tmp/rkbga-test-" + std::to_string(::getpid()) + "-" + name + ".sock";
+    }
+}
+
+RKBGA_TEST(socket_channel_retries_when_backlog_is_full) {
+    const auto peer_path = socket_path("peer");
+    const auto listener = Listener{peer_path};
+    auto channel = SocketChannel{"unix:" + socket_path("own"), {"unix:" + peer_path}};
+
+    // With the backlog full, connecting fails with EAGAIN: the channel must give up on this
+    // attempt, rather than treat the socket as being connected.
+    auto pending = listener.fill_backlog();
+    const auto frame = std::vector<uint8_t>{1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u};
+    channel.send(0u, frame);
+
+    // Free the backlog, and let the channel connect and deliver what is still queued.
+    for(auto fd = ::accept(listener.fd, nullptr, nullptr); fd >= 0; fd = ::accept(listener.fd, nullptr, nullptr)) { ::close(fd); }
+    for(const auto fd : pending) { ::close(fd); }
+
+    channel.flush();
+    const auto connection = listener.accept();
+    RKBGA_CHECK(connection >= 0);
+
+    auto received = std::vector<uint8_t>(frame.size());
+    auto size = std::size_t{0};
+    auto pfd = pollfd{connection, POLLIN, 0};
+    while(size < received.size() && ::poll(&pfd, 1, 1000) > 0) {
+        const auto n = ::recv(connection, received.data() + size, received.size() - size, 0);
+        if(n <= 0) { break; }
+        size += static_cast<std::size_t>(n);
+    }
+    ::close(connection);
+
+    RKBGA_CHECK(received == frame);
+}
@@ -0,0 +1,109 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include <string>
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/DefaultRandomVectorGenerator.h"
+#include "../src/DefaultTranspositionVectorGenerator.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/Solver.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/RandomVectorEvaluator.h"
+#include "../examples/tsp/TranspositionVectorEvaluator.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    /**
+     * Solves an instance with a given number of threads, and checks that the objective value of
+     * the best individual is the cost of the tour it decodes to.
+     */
+    template<class Generator, class Evaluator>
+    float solve(const Graph& graph, uint32_t num_threads, uint32_t visitor_freq_iterations = 10u) {
+        using Individual = typename Generator::individual_type;
+
+        const auto params = ParamsBuilder{}.with_population_size(100u).with_max_generations(60u).with_num_threads(num_threads)
+                                           .with_visitor_freq_iterations(visitor_freq_iterations).with_seed(17u).build();
+        const auto generator = Generator{graph.num_nodes()};
+        const auto evaluator = Evaluator{graph};
+        const auto visitor = tests::SilentVisitor<Individual>{};
+        auto solver = Solver<Generator, Evaluator, tests::SilentVisitor<Individual>>{params, generator, evaluator, visitor};
+
+        const auto best = solver.solve();
+        tests::check_best_matches_tour(evaluator, graph, best);
+
+        return best.objvalue;
+    }
+
+    /**
+     * A generator which can only draw from the solver's random streams in place, with
+     * generate_into: its own engine, seeded with Seed, is only used by generate.
+     */
+    template<uint32_t Seed>
+    struct InPlaceGenerator {
+        using individual_type = RandomVectorIndividual;
+
+        DefaultRandomVectorGenerator generator;
+
+        explicit InPlaceGenerator(uint32_t n) : generator{n, Seed} {}
+
+        RandomVectorIndividual generate() const { return generator.generate(); }
+
+        template<class Rng>
+        void generate_into(RandomVectorIndividual& individual, Rng& rng) const { generator.generate_into(individual, rng); }
+    };
+
+    /**
+     * Creates the initial population of gr48 with an \class InPlaceGenerator, and returns its best individual.
+     */
+    template<uint32_t Seed>
+    IndividualWithObjValue<RandomVectorIndividual> initial_best(const Graph& graph) {
+        using Visitor = tests::SilentVisitor<RandomVectorIndividual>;
+
+        const auto params = ParamsBuilder{}.with_population_size(50u).with_num_threads(2u).with_seed(17u).build();
+        const auto generator = InPlaceGenerator<Seed>{graph.num_nodes()};
+        const auto evaluator = RandomVectorEvaluator{graph};
+        const auto visitor = Visitor{};
+        const auto solver = Solver<InPlaceGenerator<Seed>, RandomVectorEvaluator, Visitor>{params, generator, evaluator, visitor};
+
+        solver.initialise();
+        return solver.best();
+    }
+}
+
+RKBGA_TEST(solver_result_does_not_depend_on_threads) {
+    const auto graph = Graph{tests::instance("gr48")};
+
+    const auto random_key_1 = solve<DefaultRandomVectorGenerator, RandomVectorEvaluator>(graph, 1u);
+    const auto random_key_3 = solve<DefaultRandomVectorGenerator, RandomVectorEvaluator>(graph, 3u);
+    RKBGA_CHECK(random_key_1 == random_key_3);
+
+    const auto transposition_1 = solve<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>(graph, 1u);
+    const auto transposition_3 = solve<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>(graph, 3u);
+    RKBGA_CHECK(transposition_1 == transposition_3);
+}
+
+RKBGA_TEST(solver_runs_without_visitor_calls) {
+    const auto graph = Graph{tests::instance("gr48")};
+
+    // A visitor frequency of 0 only leaves the calls at the start and at the end, and does not change the run.
+    const auto with_calls = solve<DefaultRandomVectorGenerator, RandomVectorEvaluator>(graph, 1u);
+    const auto without_calls = solve<DefaultRandomVectorGenerator, RandomVectorEvaluator>(graph, 1u, 0u);
+    RKBGA_CHECK(with_calls == without_calls);
+}
+
+RKBGA_TEST(initial_population_depends_on_the_seed_only) {
+    const auto graph = Graph{tests::instance("gr48")};
+
+    const auto first = initial_best<1u>(graph);
+    const auto second = initial_best<2u>(graph);
+
+    RKBGA_CHECK(first.objvalue == second.objvalue);
+    for(auto i = 0u; i < first.individual.size(); i++) { RKBGA_CHECK(first.individual.component(i) == second.individual.component(i)); }
+}
@@ -0,0 +1,99 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include "Check.h"
+#include "TestSupport.h"
+
+#include "../src/DefaultRandomVectorGenerator.h"
+#include "../src/DefaultTranspositionVectorGenerator.h"
+#include "../src/ConcurrentPopulation.h"
+#include "../src/SteadyStateSolver.h"
+#include "../src/ParamsBuilder.h"
+#include "../src/Solver.h"
+
+#include "../examples/tsp/Graph.h"
+#include "../examples/tsp/RandomVectorEvaluator.h"
+#include "../examples/tsp/TranspositionVectorEvaluator.h"
+
+using namespace bga;
+using namespace bga::tsp;
+
+namespace {
+    /**
+     * Solves gr48 with the steady-state solver and with the generational one, on the same budget of
+     * new individuals; checks that the steady-state result is consistent, and not much worse.
+     */
+    template<class Generator, class Evaluator>
+    void check_steady_state(uint32_t num_threads) {
+        using Individual = typename Generator::individual_type;
+        using Visitor = tests::SilentVisitor<Individual>;
+
+        const auto graph = Graph{tests::instance("gr48")};
+        const auto generator = Generator{graph.num_nodes(), 1u};
+        const auto evaluator = Evaluator{graph};
+        const auto visitor = Visitor{};
+        const auto params = ParamsBuilder{}.with_population_size(100u).with_max_generations(200u).with_num_threads(num_threads)
+                                           .with_seed(12u).build();
+
+        const auto steady = SteadyStateSolver<Generator, Evaluator, Visitor>{params, generator, evaluator, visitor}.solve();
+        const auto generational = Solver<Generator, Evaluator, Visitor>{params, generator, evaluator, visitor}.solve();
+
+        tests::check_best_matches_tour(evaluator, graph, steady);
+        RKBGA_CHECK(steady.objvalue < 1.25f * generational.objvalue);
+    }
+}
+
+RKBGA_TEST(concurrent_population_keeps_the_mutant_tier) {
+    // Slots 0-9, with objective values 0-9: elite {0, 1}, non-elite {2, ..., 7}, mutants {8, 9}.
+    auto individuals = std::vector<uint32_t>(10u);
+    auto objvalues = std::vector<float>(10u);
+    for(auto i = 0u; i < 10u; i++) { individuals[i] = i; objvalues[i] = static_cast<float>(i); }
+
+    auto population = ConcurrentPopulation<uint32_t>{};
+    population.assign(individuals, objvalues, 2u, 2u);
+    RKBGA_CHECK(population.elite_size() == 2u && population.non_elite_size() == 8u);
+
+    // An offspring worse than the worst non-elite individual is rejected.
+    auto offspring = 100u;
+    RKBGA_CHECK(!population.insert(offspring, 7.5f));
+
+    // A mutant enters the tier even if it is the worst individual, and evicts the oldest mutant
+    // (8), which also is not good enough for the non-elite.
+    auto mutant = 101u;
+    population.insert_mutant(mutant, 50.0f);
+    RKBGA_CHECK(mutant == 8u);
+
+    // The next mutant evicts 9, which is not good enough either; the one after that evicts 101,
+    // and is the new best individual.
+    mutant = 102u;
+    population.insert_mutant(mutant, 60.0f);
+    RKBGA_CHECK(mutant == 9u);
+    mutant = 103u;
+    population.insert_mutant(mutant, -1.0f);
+    RKBGA_CHECK(mutant == 101u);
+    RKBGA_CHECK(population.best().individual == 103u);
+
+    // A good offspring evicts the worst non-elite individual (7), and demotes the worst elite one.
+    offspring = 104u;
+    RKBGA_CHECK(population.insert(offspring, 0.5f));
+    RKBGA_CHECK(offspring == 7u);
+
+    auto elite = std::vector<uint32_t>();
+    for(auto e = 0u; e < population.elite_size(); e++) {
+        population.read_parents(e, 0u, [&elite] (uint32_t individual, uint32_t) { elite.push_back(individual); });
+    }
+    std::sort(elite.begin(), elite.end());
+    RKBGA_CHECK((elite == std::vector<uint32_t>{0u, 104u}));
+}
+
+RKBGA_TEST(steady_state_solver_random_keys) {
+    check_steady_state<DefaultRandomVectorGenerator, RandomVectorEvaluator>(1u);
+    check_steady_state<DefaultRandomVectorGenerator, RandomVectorEvaluator>(3u);
+}
+
+RKBGA_TEST(steady_state_solver_transpositions) {
+    check_steady_state<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>(1u);
+    check_steady_state<DefaultTranspositionVectorGenerator, TranspositionVectorEvaluator>(3u);
+}
@@ -0,0 +1,62 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#ifndef RKBGA_TESTS_TESTSUPPORT_H
+#define RKBGA_TESTS_TESTSUPPORT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Check.h"
+#include "../src/IndividualWithObjValue.h"
+
+namespace bga {
+    namespace tests {
+        /**
+         * Path of a bundled TSPLIB instance.
+         */
+        inline std::string instance(const std::string& name) {
+            return std::string{RKBGA_DATA_DIR} + "/" + name + ".tsp";
+        }
+
+        /**
+         * Whether a vector is a permutation of 0, ..., n-1.
+         */
+        inline bool is_tour(const std::vector<uint32_t>& tour, uint32_t n) {
+            if(tour.size() != n) { return false; }
+
+            auto seen = std::vector<bool>(n, false);
+            for(const auto node : tour) {
+                if(node >= n || seen[node]) { return false; }
+                seen[node] = true;
+            }
+
+            return true;
+        }
+
+        /**
+         * Checks that the best individual found by a solver decodes to a tour of a graph, and that
+         * its objective value is the cost of that tour.
+         */
+        template<class Evaluator, class Graph, class Individual>
+        void check_best_matches_tour(const Evaluator& evaluator, const Graph& graph, const IndividualWithObjValue<Individual>& best) {
+            auto tour = std::vector<uint32_t>();
+            evaluator.decode(best.individual, tour);
+            RKBGA_CHECK(is_tour(tour, graph.num_nodes()));
+            RKBGA_CHECK_NEAR(best.objvalue, graph.tour_cost(tour), 1e-3 * graph.tour_cost(tour));
+        }
+
+        /**
+         * A visitor which does nothing.
+         */
+        template<class Individual>
+        struct SilentVisitor {
+            void at_start(const IndividualWithObjValue<Individual>&) const {}
+            void at_iteration(const IndividualWithObjValue<Individual>&, uint32_t, float) const {}
+            void at_end(const IndividualWithObjValue<Individual>&, uint32_t, float) const {}
+        };
+    }
+}
+
+#endif //RKBGA_TESTS_TESTSUPPORT_H
@@ -0,0 +1,52 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include "Check.h"
+#include "../src/ThreadPool.h"
+
+using namespace bga;
+
+RKBGA_TEST(thread_pool_calls_each_index_once) {
+    auto pool = ThreadPool{4u};
+
+    for(const auto chunk_size : {0u, 1u, 7u}) {
+        auto calls = std::vector<std::atomic<uint32_t>>(1000u);
+        pool.parallel_for(0u, 1000u, [&calls] (uint32_t i) { calls[i].fetch_add(1u); }, chunk_size);
+
+        for(const auto& count : calls) { RKBGA_CHECK(count.load() == 1u); }
+    }
+}
+
+RKBGA_TEST(thread_pool_runs_many_small_batches) {
+    // Many short batches, so that workers often steal tasks just pushed by the calling thread.
+    auto pool = ThreadPool{4u};
+    auto total = std::atomic<uint64_t>{0u};
+
+    for(auto batch = 0u; batch < 2000u; batch++) {
+        pool.parallel_for(0u, 16u, [&total] (uint32_t i) { total.fetch_add(i); }, 1u);
+    }
+
+    RKBGA_CHECK(total.load() == 2000u * 120u);
+}
+
+RKBGA_TEST(thread_pool_rethrows_exceptions) {
+    auto pool = ThreadPool{3u};
+    auto thrown = false;
+
+    try {
+        pool.parallel_for(0u, 100u, [] (uint32_t i) { if(i == 42u) { throw std::runtime_error{"42"}; } }, 1u);
+    } catch(const std::runtime_error&) {
+        thrown = true;
+    }
+
+    RKBGA_CHECK(thrown);
+
+    // The pool is still usable afterwards.
+    auto calls = std::atomic<uint32_t>{0u};
+    pool.parallel_for(0u, 100u, [&calls] (uint32_t) { calls.fetch_add(1u); });
+    RKBGA_CHECK(calls.load() == 100u);
+}
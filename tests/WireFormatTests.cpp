@@ -0,0 +1,45 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <vector>
+#include <cstdint>
+#include "Check.h"
+
+#include "../src/WireFormat.h"
+
+using namespace bga;
+
+namespace {
+    /**
+     * A transposition chromosome for a permutation of 5 items.
+     */
+    TranspositionVectorIndividual transpositions() {
+        return TranspositionVectorIndividual{std::vector<uint32_t>{0u, 4u, 1u, 3u, 2u, 2u, 4u, 0u}};
+    }
+}
+
+RKBGA_TEST(wire_format_round_trips_transpositions) {
+    const auto individual = transpositions();
+
+    auto frame = std::vector<uint8_t>();
+    serialise(individual, 12.5f, frame);
+
+    const auto record = deserialise<TranspositionVectorIndividual>(frame.data(), frame.size());
+    RKBGA_CHECK(record.has_value());
+    RKBGA_CHECK(record->objvalue == 12.5f);
+    RKBGA_CHECK(record->individual.size() == individual.size());
+    for(auto i = 0u; i < individual.size(); i++) { RKBGA_CHECK(record->individual.component(i) == individual.component(i)); }
+}
+
+RKBGA_TEST(wire_format_rejects_transpositions_out_of_range) {
+    auto frame = std::vector<uint8_t>();
+    serialise(transpositions(), 12.5f, frame);
+
+    // Genes are one byte wide: the last one becomes 5, which is not an item.
+    frame.back() = 5u;
+    RKBGA_CHECK(!deserialise<TranspositionVectorIndividual>(frame.data(), frame.size()).has_value());
+
+    frame.back() = 3u;
+    RKBGA_CHECK(deserialise<TranspositionVectorIndividual>(frame.data(), frame.size()).has_value());
+}
@@ -0,0 +1,32 @@
+//
+// Created by alberto on 16/10/26.
+//
+
+#include <string>
+#include <iostream>
+#include <exception>
+#include "Check.h"
+
+/**
+ * Runs the registered tests, or only those whose name contains the first argument, and exits
+ * with a non-zero status if any of them fails.
+ * Usage: rkbga_tests [<substring>]
+ */
+int main(int argc, char* argv[]) {
+    const auto filter = (argc > 1) ? std::string(argv[1]) : std::string{};
+    auto failures = 0u;
+
+    for(const auto& test : bga::tests::registry()) {
+        if(!filter.empty() && std::string(test.name).find(filter) == std::string::npos) { continue; }
+
+        try {
+            test.run();
+            std::cout << "ok      " << test.name << std::endl;
+        } catch(const std::exception& e) {
+            ++failures;
+            std::cout << "FAILED  " << test.name << ": " << e.what() << std::endl;
+        }
+    }
+
+    return (failures == 0u) ? 0 : 1;
+}